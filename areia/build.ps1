@@ -45,6 +45,7 @@ if ( $compile -or $cleanAndCompile -or $compileAndRun -or $all ) {
         -pedantic-errors `
         -std=c99 `
         -Wno-missing-braces `
+        -pthread `
         -I include/ `
         -I ../raylib/include/ `
         -L ../raylib/lib/ `
@@ -0,0 +1,84 @@
+/**
+ * @file ThreadPool.h
+ * @author Prof. Dr. David Buzatto
+ * @brief ThreadPool struct and function declarations. A fixed set of
+ * worker threads that execute batches of indexed tasks in background.
+ * Each worker owns a range of the batch and takes tasks from its front;
+ * a worker without tasks steals from the back of the other ranges.
+ *
+ * @copyright Copyright (c) 2024
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <pthread.h>
+
+/**
+ * @brief Function executed for each task of a batch. worker is the index
+ * of the thread that executes it (0 to threadCount - 1).
+ */
+typedef void (*TaskFunction)( void *data, int task, int worker );
+
+typedef struct TaskRange {
+    pthread_mutex_t mutex;
+    int head;
+    int tail;
+} TaskRange;
+
+typedef struct ThreadPool {
+
+    pthread_t *threads;
+    TaskRange *ranges;
+    int threadCount;
+
+    pthread_mutex_t mutex;
+    pthread_cond_t batchStarted;
+    pthread_cond_t batchFinished;
+
+    TaskFunction function;
+    void *data;
+    int pendingTasks;
+    unsigned long batch;
+    bool stopping;
+
+} ThreadPool;
+
+/**
+ * @brief Creates a dinamically allocated ThreadPool with threadCount
+ * worker threads.
+ */
+ThreadPool* createThreadPool( int threadCount );
+
+/**
+ * @brief Destroys a ThreadPool, waiting for the current batch and joining
+ * all worker threads.
+ */
+void destroyThreadPool( ThreadPool *pool );
+
+/**
+ * @brief Starts executing function( data, 0 ) ... function( data,
+ * taskCount - 1 ) and returns immediately. The previous batch must be
+ * finished.
+ */
+void startThreadPoolBatch( ThreadPool *pool, int taskCount, TaskFunction function, void *data );
+
+/**
+ * @brief Waits until every task of the current batch is finished.
+ */
+void waitThreadPoolBatch( ThreadPool *pool );
+
+/**
+ * @brief Returns true if every task of the current batch is finished,
+ * without waiting.
+ */
+bool isThreadPoolBatchFinished( ThreadPool *pool );
+
+/**
+ * @brief Executes a batch and waits for it.
+ */
+void runThreadPoolBatch( ThreadPool *pool, int taskCount, TaskFunction function, void *data );
+
+/**
+ * @brief Returns the number of processors available, at least 1.
+ */
+int getProcessorCount( void );
@@ -8,7 +8,9 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <string.h>
+#include <limits.h>
 #include <math.h>
 
 /*---------------------------------------------
@@ -25,6 +27,7 @@
  * Project headers.
  --------------------------------------------*/
 #include <utils.h>
+#include <ThreadPool.h>
 
 /*---------------------------------------------
  * Macros. 
@@ -34,29 +37,82 @@
 /*--------------------------------------------
  * Constants. 
  -------------------------------------------*/
-const int SCREEN_WIDTH = 1000;
-const int SCREEN_HEIGHT = 1000;
-const int CELL_WIDTH = 2;
+const int SCREEN_WIDTH = 1600;
+const int SCREEN_HEIGHT = 900;
+
+// the world has a 4K resolution, independent of the window, and is drawn
+// scaled to it through a texture with one texel per cell
+const int GRID_LINES = 2160;
+const int GRID_COLUMNS = 3840;
 const unsigned int GRID_BACKGROUND_COLOR = 0x000000ff;
 const unsigned int GRID_COLOR = 0xccccccff;
 const bool DRAW_GRID = false;
 
+// the grid is updated by chunks; a chunk where nothing moved sleeps
+// until a grain moves near it or the brush touches it. The awake chunks
+// are updated in parallel in 4 passes, each one with the chunks of one
+// checkerboard: the chunks of a pass are two chunks apart, so the cells
+// that two workers touch (the ones of their chunks and of the chunks
+// around them) never overlap
+const int CHUNK_SIZE = 32;
+const int CHUNK_PASSES = 4;
+
+// only the chunks whose cells changed are uploaded to the texture, one
+// region each, unless they are more than 1 / FULL_UPLOAD_DIVISOR of the
+// chunks: then the whole texture is uploaded at once
+const int FULL_UPLOAD_DIVISOR = 8;
+
+// cells around a moved grain that can move next because of it (a
+// resting grain looks only at the line right below it)
+const int WAKE_MARGIN = 1;
+
 /*---------------------------------------------
  * Custom types (enums, structs, unions etc.)
  --------------------------------------------*/
 typedef struct Grain {
     unsigned int color;
     float velY;
+    bool step;          // parity of the frame of its last update
 } Grain;
 
+typedef struct Chunk {
+    // dirty rectangle of the cells to update, empty if minLine > maxLine
+    int minLine;
+    int maxLine;
+    int minColumn;
+    int maxColumn;
+} Chunk;
+
+// random number generator of a worker, alone in its cache line
+typedef struct WorkerRandom {
+    uint32_t state;
+    char padding[60];
+} WorkerRandom;
+
 typedef struct GameWorld {
     int lines;
     int columns;
     Grain *grid;
+    int chunkLines;
+    int chunkColumns;
+    Chunk *chunks;          // cells to update in this frame
+    Chunk *nextChunks;      // cells woken for the next frame
+    int *passChunks;        // awake chunks of the current pass
+    int *changedChunks;     // chunks whose colors changed in this frame
+    ThreadPool *pool;
+    WorkerRandom *randoms;  // one for each worker
+    bool step;              // parity of the current frame
     bool drawGrid;
+    bool drawChunks;
     int sandLimit;
+    float gravity;
+    int awakeChunks;
+    int updatedCells;
     Color backgroundColor;
     Color gridColor;
+    Color *pixels;          // colors of the cells, as in the texture
+    Color *chunkPixels;     // region of a chunk being uploaded
+    Texture2D texture;
 } GameWorld;
 
 
@@ -70,7 +126,7 @@ float sliderColor1 = 0.0f;
 float sliderColor2 = 55.0f;
 float sliderSat = 1.0f;
 float sliderVal = 1.0f;
-float sliderLimit = 10.0f;
+float sliderLimit = 30.0f;
 float sliderInitialVelY = 0.0f;
 float sliderGravity = 0.1f;
 
@@ -94,10 +150,20 @@ bool showControls = true;
  * @param gw GameWorld struct pointer.
  */
 void inputAndUpdate( GameWorld *gw );
-void move( int line, int column, GameWorld *gw );
+void updateSand( GameWorld *gw );
+void updateChunk( void *data, int task, int worker );
+void move( int line, int column, uint32_t *random, GameWorld *gw );
+int getRandomSide( uint32_t *random );
 void swap( int line, int column, int toLine, int toColumn, GameWorld *gw );
 bool isLineColumnOk( int line, int column, GameWorld *gw );
+bool isCellEmpty( int line, int column, GameWorld *gw );
+void wakeCells( int minLine, int maxLine, int minColumn, int maxColumn, GameWorld *gw );
+void atomicMin( int *value, int candidate );
+void atomicMax( int *value, int candidate );
 void createSand( int line, int column, int limit, float initialVelY, GameWorld *gw );
+void updateTexture( GameWorld *gw );
+void colorChunk( void *data, int task, int worker );
+Chunk getChangedCells( const GameWorld *gw, int chunk );
 
 /**
  * @brief Draws the state of the game.
@@ -150,6 +216,13 @@ void inputAndUpdate( GameWorld *gw ) {
 
     gw->sandLimit = sliderLimit;
 
+    // without gravity the grains stop, so every one of them can start
+    // to fall again when it changes
+    if ( gw->gravity != sliderGravity ) {
+        gw->gravity = sliderGravity;
+        wakeCells( 0, gw->lines - 1, 0, gw->columns - 1, gw );
+    }
+
     if ( IsMouseButtonPressed( MOUSE_BUTTON_LEFT ) ) {
 
         Vector2 p = GetMousePosition();
@@ -176,8 +249,8 @@ void inputAndUpdate( GameWorld *gw ) {
 
     if ( !draggingSliders ) {
         if ( IsMouseButtonDown( MOUSE_BUTTON_LEFT ) ) {
-            int line = GetMouseY() / CELL_WIDTH;
-            int column = GetMouseX() / CELL_WIDTH;
+            int line = GetMouseY() * gw->lines / GetScreenHeight();
+            int column = GetMouseX() * gw->columns / GetScreenWidth();
             if ( isLineColumnOk( line, column, gw ) ) {
                 int p = line * gw->columns + column;
                 if ( gw->grid[p].color == GRID_BACKGROUND_COLOR ) {
@@ -187,61 +260,162 @@ void inputAndUpdate( GameWorld *gw ) {
         }
     }
 
-    for ( int i = gw->lines-1; i >= 0; i-- ) {
-        for ( int j = gw->columns-1; j >= 0; j-- ) {
-            int p = i * gw->columns + j;
-            if ( gw->grid[p].color != GRID_BACKGROUND_COLOR && gw->grid[p].velY != 0 ) {
-                move( i, j, gw );
-            }
+    updateSand( gw );
+    updateTexture( gw );
+
+    if ( IsKeyPressed( KEY_SPACE ) ) {
+        showControls = !showControls;
+    }
+
+    if ( IsKeyPressed( KEY_D ) ) {
+        gw->drawChunks = !gw->drawChunks;
+    }
+
+}
+
+/**
+ * @brief Moves and accelerates the grains of the awake chunks, one
+ * checkerboard pass after the other, each one by the thread pool. A
+ * grain moved to a chunk of a later pass is not updated again in the
+ * same frame. The cells woken by the moves are the ones updated in the
+ * next frame.
+ */
+void updateSand( GameWorld *gw ) {
+
+    Chunk *chunks = gw->nextChunks;
+    gw->nextChunks = gw->chunks;
+    gw->chunks = chunks;
+    gw->step = !gw->step;
+
+    int chunkCount = gw->chunkLines * gw->chunkColumns;
+    gw->awakeChunks = 0;
+    gw->updatedCells = 0;
+
+    for ( int k = 0; k < chunkCount; k++ ) {
+        if ( chunks[k].minLine <= chunks[k].maxLine ) {
+            gw->awakeChunks++;
+            gw->updatedCells += ( chunks[k].maxLine - chunks[k].minLine + 1 ) * 
+                                ( chunks[k].maxColumn - chunks[k].minColumn + 1 );
         }
+        gw->nextChunks[k] = (Chunk) { INT_MAX, INT_MIN, INT_MAX, INT_MIN };
     }
 
-    for ( int i = gw->lines-1; i >= 0; i-- ) {
-        for ( int j = gw->columns-1; j >= 0; j-- ) {
-            int p = i * gw->columns + j;
-            if ( gw->grid[p].color != GRID_BACKGROUND_COLOR ) {
-                gw->grid[p].velY += sliderGravity;
+    for ( int pass = 0; pass < CHUNK_PASSES; pass++ ) {
+        int count = 0;
+        for ( int cl = pass / 2; cl < gw->chunkLines; cl += 2 ) {
+            for ( int cc = pass % 2; cc < gw->chunkColumns; cc += 2 ) {
+                int k = cl * gw->chunkColumns + cc;
+                if ( chunks[k].minLine <= chunks[k].maxLine ) {
+                    gw->passChunks[count++] = k;
+                }
             }
         }
+        if ( count > 0 ) {
+            runThreadPoolBatch( gw->pool, count, updateChunk, gw );
+        }
     }
 
-    if ( IsKeyPressed( KEY_SPACE ) ) {
-        showControls = !showControls;
+}
+
+/**
+ * @brief Moves and accelerates the grains of the dirty rectangle of an
+ * awake chunk, from bottom to top and right to left, so a grain that
+ * moves down is not updated again.
+ */
+void updateChunk( void *data, int task, int worker ) {
+
+    GameWorld *gw = (GameWorld*) data;
+    const Chunk *chunk = &gw->chunks[gw->passChunks[task]];
+    uint32_t *random = &gw->randoms[worker].state;
+
+    for ( int i = chunk->maxLine; i >= chunk->minLine; i-- ) {
+        for ( int j = chunk->maxColumn; j >= chunk->minColumn; j-- ) {
+            Grain *g = &gw->grid[i*gw->columns+j];
+            if ( g->color == GRID_BACKGROUND_COLOR ) {
+                continue;
+            }
+            if ( g->step == gw->step ) {
+                // moved here in this frame or, after sleeping, last updated
+                // in a frame of the same parity: updated in the next one
+                wakeCells( i, i, j, j, gw );
+            } else {
+                g->step = gw->step;
+                if ( g->velY != 0 ) {
+                    move( i, j, random, gw );
+                } else if ( gw->gravity != 0 ) {
+                    // a new grain starts to fall in the next frame
+                    g->velY += gw->gravity;
+                    wakeCells( i, i, j, j, gw );
+                }
+            }
+        }
     }
 
 }
 
-void move( int line, int column, GameWorld *gw ) {
+/**
+ * @brief Moves the grain down as far as its speed takes it, stopping on
+ * the first grain (or the floor) in the way, or, if it cannot go down,
+ * one line down to one of the sides, and accelerates it. A grain that
+ * cannot move with a grain (or the floor) right below it has landed and
+ * loses its speed; the others keep their chunks awake. random is the
+ * generator of the worker that moves it.
+ */
+void move( int line, int column, uint32_t *random, GameWorld *gw ) {
 
     Grain *g = &gw->grid[line*gw->columns+column];
-    int nextLine = line + (int) g->velY;
+    int lastLine = line + (int) g->velY;
+    int nextLine = line;
     int nextColumn = column;
-    int pNext = nextLine * gw->columns + nextColumn;
 
-    if ( isLineColumnOk( nextLine, nextColumn, gw ) ) {
+    // in a frame, a grain goes at most to the end of the chunk below its
+    // own, the farthest a worker can touch
+    int lowestLine = ( line / CHUNK_SIZE + 2 ) * CHUNK_SIZE - 1;
+    if ( lastLine > lowestLine ) {
+        lastLine = lowestLine;
+    }
 
-        if ( gw->grid[pNext].color == GRID_BACKGROUND_COLOR ) {
-            swap( line, column, nextLine, nextColumn, gw );
-        } else {
-            if ( GetRandomValue( 0, 1 ) == 0 ) {
-                nextColumn--;
-            } else {
-                nextColumn++;
-            }
-            nextLine = line + 1;
-            pNext = nextLine * gw->columns + nextColumn;
-            if ( isLineColumnOk( nextLine, nextColumn, gw ) ) {
-                if ( gw->grid[pNext].color == GRID_BACKGROUND_COLOR ) {
-                    swap( line, column, nextLine, nextColumn, gw );
-                }/* else {
-                    gw->grid[pNext].velY = 0;
-                }*/
-            }
-        }
+    while ( nextLine < lastLine && isCellEmpty( nextLine + 1, column, gw ) ) {
+        nextLine++;
+    }
+
+    if ( nextLine == line ) {
+        // the side tried first is random, but both are tried, so a grain
+        // that did not move stays put while its neighbors do not change
+        int side = getRandomSide( random );
+        nextLine = line + 1;
+        nextColumn = isCellEmpty( nextLine, column + side, gw ) ? column + side : column - side;
+    }
+
+    if ( isCellEmpty( nextLine, nextColumn, gw ) ) {
+        g->velY += gw->gravity;
+        swap( line, column, nextLine, nextColumn, gw );
+        wakeCells( line - WAKE_MARGIN, line + WAKE_MARGIN, 
+                   column - WAKE_MARGIN, column + WAKE_MARGIN, gw );
+        wakeCells( nextLine - WAKE_MARGIN, nextLine + WAKE_MARGIN, 
+                   nextColumn - WAKE_MARGIN, nextColumn + WAKE_MARGIN, gw );
+    } else if ( isCellEmpty( line + 1, column, gw ) ) {
+        g->velY += gw->gravity;
+        wakeCells( line, line, column, column, gw );
+    } else {
+        g->velY = gw->gravity;
     }
 
 }
 
+/**
+ * @brief Returns -1 or 1 at random, from a xorshift generator.
+ */
+int getRandomSide( uint32_t *random ) {
+    // based on https://en.wikipedia.org/wiki/Xorshift
+    uint32_t x = *random;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *random = x;
+    return x >> 31 ? 1 : -1;
+}
+
 void swap( int line, int column, int toLine, int toColumn, GameWorld *gw ) {
     int p1 = line * gw->columns + column;
     int p2 = toLine * gw->columns + toColumn;
@@ -254,14 +428,75 @@ bool isLineColumnOk( int line, int column, GameWorld *gw ) {
     return line >= 0 && line < gw->lines && column >= 0 && column < gw->columns;
 }
 
+bool isCellEmpty( int line, int column, GameWorld *gw ) {
+    return isLineColumnOk( line, column, gw ) && 
+           gw->grid[line*gw->columns+column].color == GRID_BACKGROUND_COLOR;
+}
+
+/**
+ * @brief Adds the cells of the rectangle (clipped to the grid) to the
+ * dirty rectangles of the chunks it overlaps, for the next frame. The
+ * workers of neighboring chunks can wake the same chunk, so its
+ * rectangle only grows atomically.
+ */
+void wakeCells( int minLine, int maxLine, int minColumn, int maxColumn, GameWorld *gw ) {
+
+    minLine = minLine < 0 ? 0 : minLine;
+    maxLine = maxLine >= gw->lines ? gw->lines - 1 : maxLine;
+    minColumn = minColumn < 0 ? 0 : minColumn;
+    maxColumn = maxColumn >= gw->columns ? gw->columns - 1 : maxColumn;
+
+    for ( int cl = minLine / CHUNK_SIZE; cl <= maxLine / CHUNK_SIZE; cl++ ) {
+        for ( int cc = minColumn / CHUNK_SIZE; cc <= maxColumn / CHUNK_SIZE; cc++ ) {
+
+            Chunk *chunk = &gw->nextChunks[cl*gw->chunkColumns+cc];
+            int top = cl * CHUNK_SIZE;
+            int left = cc * CHUNK_SIZE;
+            int bottom = top + CHUNK_SIZE - 1;
+            int right = left + CHUNK_SIZE - 1;
+
+            top = minLine > top ? minLine : top;
+            left = minColumn > left ? minColumn : left;
+            bottom = maxLine < bottom ? maxLine : bottom;
+            right = maxColumn < right ? maxColumn : right;
+
+            atomicMin( &chunk->minLine, top );
+            atomicMax( &chunk->maxLine, bottom );
+            atomicMin( &chunk->minColumn, left );
+            atomicMax( &chunk->maxColumn, right );
+
+        }
+    }
+
+}
+
+void atomicMin( int *value, int candidate ) {
+    int current = __atomic_load_n( value, __ATOMIC_RELAXED );
+    while ( candidate < current &&
+            !__atomic_compare_exchange_n( value, &current, candidate, true, 
+                                          __ATOMIC_RELAXED, __ATOMIC_RELAXED ) ) {
+    }
+}
+
+void atomicMax( int *value, int candidate ) {
+    int current = __atomic_load_n( value, __ATOMIC_RELAXED );
+    while ( candidate > current &&
+            !__atomic_compare_exchange_n( value, &current, candidate, true, 
+                                          __ATOMIC_RELAXED, __ATOMIC_RELAXED ) ) {
+    }
+}
+
 void createSand( int line, int column, int limit, float initialVelY, GameWorld *gw ) {
 
+    wakeCells( line - limit, line + limit, column - limit, column + limit, gw );
+
     for ( int i = line - limit; i < line + limit + 1; i++ ) {
         for ( int j = column - limit; j < column + limit + 1; j++ ) {
             if ( isLineColumnOk( i, j, gw ) ) {
                 if ( GetRandomValue( 0, 10 ) == 0 ) {
                     gw->grid[i*gw->columns+j].color = ColorToInt( currentColor );
                     gw->grid[i*gw->columns+j].velY = initialVelY;
+                    gw->grid[i*gw->columns+j].step = gw->step;
                 }
             }
         }
@@ -269,37 +504,140 @@ void createSand( int line, int column, int limit, float initialVelY, GameWorld *
 
 }
 
+/**
+ * @brief Copies the colors of the cells that may have changed in this
+ * frame to the texture. The pixels of the changed chunks are colored by
+ * the thread pool and uploaded one region per chunk or, when many
+ * chunks changed, all at once.
+ */
+void updateTexture( GameWorld *gw ) {
+
+    int chunkCount = gw->chunkLines * gw->chunkColumns;
+    int count = 0;
+
+    for ( int k = 0; k < chunkCount; k++ ) {
+        Chunk cells = getChangedCells( gw, k );
+        if ( cells.minLine <= cells.maxLine ) {
+            gw->changedChunks[count++] = k;
+        }
+    }
+
+    if ( count == 0 ) {
+        return;
+    }
+
+    runThreadPoolBatch( gw->pool, count, colorChunk, gw );
+
+    if ( count > chunkCount / FULL_UPLOAD_DIVISOR ) {
+        UpdateTexture( gw->texture, gw->pixels );
+        return;
+    }
+
+    for ( int k = 0; k < count; k++ ) {
+
+        Chunk cells = getChangedCells( gw, gw->changedChunks[k] );
+        int width = cells.maxColumn - cells.minColumn + 1;
+        int height = cells.maxLine - cells.minLine + 1;
+
+        for ( int i = 0; i < height; i++ ) {
+            memcpy( &gw->chunkPixels[i*width], 
+                    &gw->pixels[(cells.minLine+i)*gw->columns+cells.minColumn], 
+                    width * sizeof( Color ) );
+        }
+
+        UpdateTextureRec( gw->texture, 
+                          (Rectangle) { cells.minColumn, cells.minLine, width, height }, 
+                          gw->chunkPixels );
+
+    }
+
+}
+
+/**
+ * @brief Colors the pixels of the changed cells of a chunk.
+ */
+void colorChunk( void *data, int task, int worker ) {
+
+    GameWorld *gw = (GameWorld*) data;
+    Chunk cells = getChangedCells( gw, gw->changedChunks[task] );
+
+    for ( int i = cells.minLine; i <= cells.maxLine; i++ ) {
+        for ( int j = cells.minColumn; j <= cells.maxColumn; j++ ) {
+            gw->pixels[i*gw->columns+j] = GetColor( gw->grid[i*gw->columns+j].color );
+        }
+    }
+
+}
+
+/**
+ * @brief Returns the cells of a chunk that may have changed in this
+ * frame: a grain moved from a cell of the rectangle just updated to a
+ * cell woken for the next frame, and new grains are created in woken
+ * cells. The rectangles are joined into the one that holds both (empty
+ * rectangles, with INT_MAX and INT_MIN bounds, do not change it).
+ */
+Chunk getChangedCells( const GameWorld *gw, int chunk ) {
+
+    const Chunk *updated = &gw->chunks[chunk];
+    const Chunk *woken = &gw->nextChunks[chunk];
+
+    return (Chunk) {
+        .minLine = updated->minLine < woken->minLine ? updated->minLine : woken->minLine,
+        .maxLine = updated->maxLine > woken->maxLine ? updated->maxLine : woken->maxLine,
+        .minColumn = updated->minColumn < woken->minColumn ? updated->minColumn : woken->minColumn,
+        .maxColumn = updated->maxColumn > woken->maxColumn ? updated->maxColumn : woken->maxColumn
+    };
+
+}
+
 void draw( const GameWorld *gw ) {
 
     BeginDrawing();
     ClearBackground( gw->backgroundColor );
 
-    for ( int i = 0; i < gw->lines; i++ ) {
-        for ( int j = 0; j < gw->columns; j++ ) {
-            int p = i * gw->columns + j;
-            if ( gw->grid[p].color != GRID_BACKGROUND_COLOR ) {
-                DrawRectangle( j * CELL_WIDTH, i * CELL_WIDTH, CELL_WIDTH, CELL_WIDTH, GetColor( gw->grid[p].color ) );
-            }
-        }
-    }
+    // size of a cell in the window
+    float cellWidth = GetScreenWidth() / (float) gw->columns;
+    float cellHeight = GetScreenHeight() / (float) gw->lines;
+
+    DrawTexturePro( gw->texture, 
+                    (Rectangle) { 0, 0, gw->columns, gw->lines }, 
+                    (Rectangle) { 0, 0, GetScreenWidth(), GetScreenHeight() }, 
+                    (Vector2) { 0 }, 0, WHITE );
 
     if ( gw->drawGrid ) {
         for ( int i = 1; i < gw->lines; i++ ) {
-            DrawLine( 0, i * CELL_WIDTH, GetScreenWidth(), i * CELL_WIDTH, gw->gridColor );
+            DrawLine( 0, i * cellHeight, GetScreenWidth(), i * cellHeight, gw->gridColor );
         }
         for ( int i = 1; i < gw->columns; i++ ) {
-            DrawLine( i * CELL_WIDTH, 0, i * CELL_WIDTH, GetScreenHeight(), gw->gridColor );
+            DrawLine( i * cellWidth, 0, i * cellWidth, GetScreenHeight(), gw->gridColor );
+        }
+    }
+
+    if ( gw->drawChunks ) {
+        for ( int k = 0; k < gw->chunkLines * gw->chunkColumns; k++ ) {
+            const Chunk *chunk = &gw->chunks[k];
+            if ( chunk->minLine <= chunk->maxLine ) {
+                DrawRectangleLinesEx( (Rectangle) { chunk->minColumn * cellWidth, chunk->minLine * cellHeight, 
+                                                    ( chunk->maxColumn - chunk->minColumn + 1 ) * cellWidth, 
+                                                    ( chunk->maxLine - chunk->minLine + 1 ) * cellHeight }, 
+                                      1, GREEN );
+            }
         }
     }
 
     if ( showControls ) {
 
+        DrawText( TextFormat( "pedaços acordados: %d de %d, %d células atualizadas (D mostra), %d threads", 
+                              gw->awakeChunks, gw->chunkLines * gw->chunkColumns, gw->updatedCells,
+                              gw->pool->threadCount ), 
+                  400, 110, 10, WHITE );
+
         GuiSlider( sliderColor1Rect, "Cor 1:", TextFormat("%2.2f", sliderColor1), &sliderColor1, 0, 360 );
         GuiSlider( sliderColor2Rect, "Cor 2:", TextFormat("%2.2f", sliderColor2), &sliderColor2, 0, 360 );
         GuiSlider( sliderSatRect, "Sat:", TextFormat("%2.2f", sliderSat), &sliderSat, 0, 1 );
         GuiSlider( sliderValRect, "Val:", TextFormat("%2.2f", sliderVal), &sliderVal, 0, 1 );
 
-        GuiSlider( sliderLimitRect, "Quantidade:", TextFormat("%2.2f", sliderLimit), &sliderLimit, 1, 20 );
+        GuiSlider( sliderLimitRect, "Quantidade:", TextFormat("%2.2f", sliderLimit), &sliderLimit, 1, 80 );
         GuiSlider( sliderInitialVelYRect, "Vel. Y:", TextFormat("%2.2f", sliderInitialVelY), &sliderInitialVelY, 0, 2 );
         GuiSlider( sliderGravityRect, "Gravidade:", TextFormat("%2.2f", sliderGravity), &sliderGravity, 0, 2 );
 
@@ -345,13 +683,28 @@ void createGameWorld( void ) {
     printf( "creating game world...\n" );
 
     gw = (GameWorld) {
-        .lines = SCREEN_HEIGHT / CELL_WIDTH,
-        .columns = SCREEN_WIDTH / CELL_WIDTH,
+        .lines = GRID_LINES,
+        .columns = GRID_COLUMNS,
         .grid = NULL,
+        .chunkLines = ( GRID_LINES + CHUNK_SIZE - 1 ) / CHUNK_SIZE,
+        .chunkColumns = ( GRID_COLUMNS + CHUNK_SIZE - 1 ) / CHUNK_SIZE,
+        .chunks = NULL,
+        .nextChunks = NULL,
+        .passChunks = NULL,
+        .changedChunks = NULL,
+        .pool = createThreadPool( getProcessorCount() ),
+        .randoms = NULL,
+        .step = false,
         .drawGrid = DRAW_GRID,
+        .drawChunks = false,
         .sandLimit = sliderLimit,
+        .gravity = sliderGravity,
+        .awakeChunks = 0,
+        .updatedCells = 0,
         .backgroundColor = GetColor( GRID_BACKGROUND_COLOR ),
-        .gridColor = GetColor( GRID_COLOR )
+        .gridColor = GetColor( GRID_COLOR ),
+        .pixels = NULL,
+        .chunkPixels = NULL
     };
 
     gw.grid = (Grain*) malloc( gw.lines * gw.columns * sizeof( Grain ) );
@@ -360,14 +713,50 @@ void createGameWorld( void ) {
         for ( int j = 0; j < gw.columns; j++ ) {
             gw.grid[i*gw.columns+j].color = GRID_BACKGROUND_COLOR;
             gw.grid[i*gw.columns+j].velY = 0;
+            gw.grid[i*gw.columns+j].step = false;
         }
     }
 
+    int chunkCount = gw.chunkLines * gw.chunkColumns;
+    gw.chunks = (Chunk*) malloc( chunkCount * sizeof( Chunk ) );
+    gw.nextChunks = (Chunk*) malloc( chunkCount * sizeof( Chunk ) );
+    for ( int k = 0; k < chunkCount; k++ ) {
+        gw.chunks[k] = (Chunk) { INT_MAX, INT_MIN, INT_MAX, INT_MIN };
+        gw.nextChunks[k] = gw.chunks[k];
+    }
+    gw.passChunks = (int*) malloc( chunkCount * sizeof( int ) );
+    gw.changedChunks = (int*) malloc( chunkCount * sizeof( int ) );
+
+    gw.pixels = (Color*) malloc( gw.lines * gw.columns * sizeof( Color ) );
+    for ( int i = 0; i < gw.lines * gw.columns; i++ ) {
+        gw.pixels[i] = gw.backgroundColor;
+    }
+    gw.chunkPixels = (Color*) malloc( CHUNK_SIZE * CHUNK_SIZE * sizeof( Color ) );
+
+    Image image = GenImageColor( gw.columns, gw.lines, gw.backgroundColor );
+    gw.texture = LoadTextureFromImage( image );
+    SetTextureFilter( gw.texture, TEXTURE_FILTER_BILINEAR );
+    UnloadImage( image );
+
+    gw.randoms = (WorkerRandom*) malloc( gw.pool->threadCount * sizeof( WorkerRandom ) );
+    for ( int i = 0; i < gw.pool->threadCount; i++ ) {
+        gw.randoms[i].state = (uint32_t) GetRandomValue( 1, INT_MAX );
+    }
+
 }
 
 void destroyGameWorld( void ) {
     printf( "destroying game world...\n" );
     free( gw.grid );
+    destroyThreadPool( gw.pool );
+    free( gw.chunks );
+    free( gw.nextChunks );
+    free( gw.passChunks );
+    free( gw.changedChunks );
+    free( gw.randoms );
+    free( gw.pixels );
+    free( gw.chunkPixels );
+    UnloadTexture( gw.texture );
 }
 
 void loadResources( void ) {
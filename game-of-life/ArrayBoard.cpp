@@ -0,0 +1,225 @@
+/**
+ * @file ArrayBoard.cpp
+ * @author Prof. Dr. David Buzatto
+ * @brief ArrayBoard class implementation.
+ * 
+ * @copyright Copyright (c) 2024
+ */
+#include <ArrayBoard.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <LifeRule.h>
+
+static const int TILE_SIZE = 32;
+
+ArrayBoard::ArrayBoard( int lines, int columns ) :
+    GridBoard( lines, columns, TILE_SIZE, TILE_SIZE ) {
+
+    paddedColumns = columns + 2;
+    evolutionArraySize = ( lines + 2 ) * paddedColumns;
+    evolutionArray = new int[evolutionArraySize];
+    newGeneration = new int[evolutionArraySize];
+
+    std::fill_n( evolutionArray, evolutionArraySize, 0 );
+    std::fill_n( newGeneration, evolutionArraySize, 0 );
+
+    selectTileKernel();
+
+}
+
+ArrayBoard::~ArrayBoard() {
+    delete[] evolutionArray;
+    delete[] newGeneration;
+}
+
+bool ArrayBoard::createNewTile( int tileLine, int tileColumn ) {
+    return ( this->*tileKernel )( tileLine, tileColumn );
+}
+
+/**
+ * @brief Selects a kernel specialized at compile time if the rule is one
+ * of the common ones or the table driven kernel otherwise.
+ */
+void ArrayBoard::selectTileKernel() {
+
+    static const struct {
+        unsigned int birth;
+        unsigned int survival;
+        TileKernel kernel;
+    } KERNELS[] = {
+        { CONWAY_BIRTH, CONWAY_SURVIVAL, 
+          &ArrayBoard::createNewTileWithRule<CONWAY_BIRTH, CONWAY_SURVIVAL> },
+        { HIGHLIFE_BIRTH, HIGHLIFE_SURVIVAL, 
+          &ArrayBoard::createNewTileWithRule<HIGHLIFE_BIRTH, HIGHLIFE_SURVIVAL> },
+        { DAY_AND_NIGHT_BIRTH, DAY_AND_NIGHT_SURVIVAL, 
+          &ArrayBoard::createNewTileWithRule<DAY_AND_NIGHT_BIRTH, DAY_AND_NIGHT_SURVIVAL> },
+        { SEEDS_BIRTH, SEEDS_SURVIVAL, 
+          &ArrayBoard::createNewTileWithRule<SEEDS_BIRTH, SEEDS_SURVIVAL> },
+        { LIFE_WITHOUT_DEATH_BIRTH, LIFE_WITHOUT_DEATH_SURVIVAL, 
+          &ArrayBoard::createNewTileWithRule<LIFE_WITHOUT_DEATH_BIRTH, LIFE_WITHOUT_DEATH_SURVIVAL> },
+        { MORLEY_BIRTH, MORLEY_SURVIVAL, 
+          &ArrayBoard::createNewTileWithRule<MORLEY_BIRTH, MORLEY_SURVIVAL> },
+        { REPLICATOR_BIRTH, REPLICATOR_SURVIVAL, 
+          &ArrayBoard::createNewTileWithRule<REPLICATOR_BIRTH, REPLICATOR_SURVIVAL> }
+    };
+
+    for ( int n = 0; n <= 8; n++ ) {
+        nextState[0][n] = ( rule.getBirth() >> n ) & 1;
+        nextState[1][n] = ( rule.getSurvival() >> n ) & 1;
+    }
+
+    tileKernel = &ArrayBoard::createNewTileWithTable;
+
+    for ( const auto &entry : KERNELS ) {
+        if ( entry.birth == rule.getBirth() && entry.survival == rule.getSurvival() ) {
+            tileKernel = entry.kernel;
+        }
+    }
+
+}
+
+template<unsigned int BIRTH, unsigned int SURVIVAL>
+bool ArrayBoard::createNewTileWithRule( int tileLine, int tileColumn ) {
+    return createNewTileCells( tileLine, tileColumn, []( int alive, int n ) {
+        return (int) ( ( ( alive ? SURVIVAL : BIRTH ) >> n ) & 1 );
+    });
+}
+
+bool ArrayBoard::createNewTileWithTable( int tileLine, int tileColumn ) {
+    return createNewTileCells( tileLine, tileColumn, [this]( int alive, int n ) {
+        return nextState[alive][n];
+    });
+}
+
+/**
+ * @brief Computes the cells of one tile, where nextState( alive, n )
+ * returns the next state of a cell with n live neighbors.
+ */
+template<typename NextState>
+bool ArrayBoard::createNewTileCells( int tileLine, int tileColumn, NextState nextState ) {
+
+    int startLine = tileLine * tileHeight;
+    int endLine = std::min( startLine + tileHeight, lines );
+    int startColumn = tileColumn * tileWidth;
+    int endColumn = std::min( startColumn + tileWidth, columns );
+    bool changed = false;
+
+    for ( int i = startLine; i < endLine; i++ ) {
+        for ( int j = startColumn; j < endColumn; j++ ) {
+            int p = index( i, j );
+            newGeneration[p] = nextState( evolutionArray[p], countNeighbors( p ) );
+            changed |= newGeneration[p] != evolutionArray[p];
+        }
+    }
+
+    return changed;
+
+}
+
+void ArrayBoard::swapGenerations() {
+    std::swap( evolutionArray, newGeneration );
+}
+
+/**
+ * @brief Hashes each line of the tile packed in one word (the tiles are
+ * 32 cells wide).
+ */
+uint64_t ArrayBoard::hashTile( int tileLine, int tileColumn ) const {
+
+    int startLine = tileLine * tileHeight;
+    int endLine = std::min( startLine + tileHeight, lines );
+    int startColumn = tileColumn * tileWidth;
+    int endColumn = std::min( startColumn + tileWidth, columns );
+    uint64_t hash = 0;
+
+    for ( int i = startLine; i < endLine; i++ ) {
+        const int *line = evolutionArray + index( i, 0 );
+        uint64_t word = 0;
+        for ( int j = startColumn; j < endColumn; j++ ) {
+            word |= (uint64_t) line[j] << ( j - startColumn );
+        }
+        hash = mixHash( hash, word );
+    }
+
+    return hash;
+
+}
+
+/**
+ * @brief Copies the opposite edges to the halo when the board is toroidal
+ * or fills it with dead cells otherwise.
+ */
+void ArrayBoard::refreshHalo() {
+
+    for ( int i = 1; i <= lines; i++ ) {
+        int *line = evolutionArray + i * paddedColumns;
+        line[0] = torus ? line[columns] : 0;
+        line[columns+1] = torus ? line[1] : 0;
+    }
+
+    int *top = evolutionArray;
+    int *bottom = evolutionArray + ( lines + 1 ) * paddedColumns;
+
+    if ( torus ) {
+        std::copy_n( evolutionArray + lines * paddedColumns, paddedColumns, top );
+        std::copy_n( evolutionArray + paddedColumns, paddedColumns, bottom );
+    } else {
+        std::fill_n( top, paddedColumns, 0 );
+        std::fill_n( bottom, paddedColumns, 0 );
+    }
+
+}
+
+/**
+ * @brief Counts the live neighbors of the cell at the padded position p.
+ */
+int ArrayBoard::countNeighbors( int p ) const {
+    const int *above = evolutionArray + p - paddedColumns;
+    const int *current = evolutionArray + p;
+    const int *below = evolutionArray + p + paddedColumns;
+    return above[-1] + above[0] + above[1] +
+           current[-1] + current[1] +
+           below[-1] + below[0] + below[1];
+}
+
+/**
+ * @brief Returns the position of a cell in the padded arrays.
+ */
+int ArrayBoard::index( int line, int column ) const {
+    return ( line + 1 ) * paddedColumns + column + 1;
+}
+
+bool ArrayBoard::getCell( int line, int column ) const {
+    return evolutionArray[index( line, column )] != 0;
+}
+
+void ArrayBoard::setCell( int line, int column, bool alive ) {
+    evolutionArray[index( line, column )] = alive ? 1 : 0;
+    wakeTilesAround( line, column );
+}
+
+void ArrayBoard::clear() {
+    std::fill_n( evolutionArray, evolutionArraySize, 0 );
+    wakeAllTiles();
+}
+
+void ArrayBoard::readRegion( int line, int column, int height, int width, unsigned char *cells ) const {
+
+    if ( line < 0 || column < 0 || line + height > lines || column + width > columns ) {
+        LifeBoard::readRegion( line, column, height, width, cells );
+        return;
+    }
+
+    for ( int i = 0; i < height; i++ ) {
+        const int *source = evolutionArray + index( line + i, column );
+        for ( int j = 0; j < width; j++ ) {
+            cells[i*width+j] = source[j] ? 1 : 0;
+        }
+    }
+
+}
+
+const char *ArrayBoard::getName() const {
+    return "int por célula";
+}
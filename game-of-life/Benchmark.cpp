@@ -0,0 +1,325 @@
+/**
+ * @file Benchmark.cpp
+ * @author Prof. Dr. David Buzatto
+ * @brief Headless benchmark implementation.
+ * 
+ * This file must not include raylib.h, since windows.h (used to query the
+ * memory usage on Windows) declares names that clash with raylib.
+ * 
+ * @copyright Copyright (c) 2024
+ */
+#include <Benchmark.h>
+
+#include <iostream>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#define PSAPI_VERSION 2
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+#include <LifeBoard.h>
+#include <GridBoard.h>
+#include <ArrayBoard.h>
+#include <BitBoard.h>
+#include <HashLifeBoard.h>
+#include <ThreadPool.h>
+#include <LifeRule.h>
+#include <Patterns.h>
+#include <PatternFile.h>
+
+struct BenchmarkOptions {
+    std::string board = "all";
+    int lines = 960;
+    int columns = 960;
+    long long generations = 1000;
+    int threads = 1;
+    bool tiles = true;
+    bool torus = false;
+    int step = 0;
+    std::string pattern = "random";
+    std::string rule = "B3/S23";
+    double density = 0.3;
+    unsigned int seed = 42;
+    bool header = true;
+};
+
+/**
+ * @brief Returns the peak resident memory of the process in kilobytes.
+ */
+static long long getPeakMemory() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if ( GetProcessMemoryInfo( GetCurrentProcess(), &counters, sizeof( counters ) ) ) {
+        return counters.PeakWorkingSetSize / 1024;
+    }
+    return -1;
+#else
+    struct rusage usage;
+    if ( getrusage( RUSAGE_SELF, &usage ) == 0 ) {
+        return usage.ru_maxrss;
+    }
+    return -1;
+#endif
+}
+
+static bool parseOptions( int argc, char **argv, BenchmarkOptions &options ) {
+
+    for ( int i = 1; i < argc; i++ ) {
+
+        std::string arg = argv[i];
+
+        if ( arg == "--benchmark" ) {
+            continue;
+        }
+
+        if ( i + 1 >= argc ) {
+            std::cerr << "missing value for " << arg << std::endl;
+            return false;
+        }
+
+        std::string value = argv[++i];
+
+        try {
+            if ( arg == "--board" ) {
+                options.board = value;
+            } else if ( arg == "--lines" ) {
+                options.lines = std::stoi( value );
+            } else if ( arg == "--columns" ) {
+                options.columns = std::stoi( value );
+            } else if ( arg == "--generations" ) {
+                options.generations = std::stoll( value );
+            } else if ( arg == "--threads" ) {
+                options.threads = std::stoi( value );
+            } else if ( arg == "--tiles" ) {
+                options.tiles = value == "on";
+            } else if ( arg == "--torus" ) {
+                options.torus = value == "on";
+            } else if ( arg == "--step" ) {
+                options.step = std::stoi( value );
+            } else if ( arg == "--pattern" ) {
+                options.pattern = value;
+            } else if ( arg == "--rule" ) {
+                options.rule = value;
+            } else if ( arg == "--density" ) {
+                options.density = std::stod( value );
+            } else if ( arg == "--seed" ) {
+                options.seed = std::stoul( value );
+            } else if ( arg == "--header" ) {
+                options.header = value == "on";
+            } else {
+                std::cerr << "unknown option " << arg << std::endl;
+                return false;
+            }
+        } catch ( const std::exception & ) {
+            std::cerr << "invalid value for " << arg << ": " << value << std::endl;
+            return false;
+        }
+
+    }
+
+    if ( options.lines <= 0 || options.columns <= 0 || options.generations <= 0 || options.threads <= 0 ) {
+        std::cerr << "lines, columns, generations and threads must be positive" << std::endl;
+        return false;
+    }
+
+    LifeRule rule;
+    if ( !LifeRule::parse( options.rule.c_str(), rule ) ) {
+        std::cerr << "invalid rule " << options.rule << std::endl;
+        return false;
+    }
+
+    return true;
+
+}
+
+static LifeBoard *createBenchmarkBoard( const std::string &name, const BenchmarkOptions &options ) {
+
+    if ( name == "array" ) {
+        return new ArrayBoard( options.lines, options.columns );
+    } else if ( name == "bit" ) {
+        return new BitBoard( options.lines, options.columns );
+    } else if ( name == "hashlife" ) {
+        HashLifeBoard *board = new HashLifeBoard( options.lines, options.columns );
+        board->setStepExponent( options.step );
+        return board;
+    }
+
+    return nullptr;
+
+}
+
+/**
+ * @brief Runs the benchmark of one board and prints its CSV line. Returns
+ * false if the board could not be created or prepared.
+ */
+static bool runBoardBenchmark( const std::string &name, const BenchmarkOptions &options, ThreadPool *threadPool ) {
+
+    LifeBoard *board = createBenchmarkBoard( name, options );
+    if ( board == nullptr ) {
+        std::cerr << "unknown board " << name << std::endl;
+        return false;
+    }
+
+    GridBoard *gridBoard = dynamic_cast<GridBoard*>( board );
+    if ( gridBoard != nullptr ) {
+        gridBoard->setTileTracking( options.tiles );
+        gridBoard->setTorus( options.torus );
+    }
+
+    LifeRule rule;
+    LifeRule::parse( options.rule.c_str(), rule );
+    if ( !board->setRule( rule ) ) {
+        std::cerr << "board " << name << " does not support the rule " << options.rule << std::endl;
+        delete board;
+        return false;
+    }
+
+    if ( options.pattern == "default" ) {
+        placeDefaultPattern( *board );
+    } else if ( options.pattern == "random" ) {
+        placeRandomSoup( *board, options.density, options.seed );
+    } else if ( !loadPattern( *board, options.pattern.c_str() ) ) {
+        delete board;
+        return false;
+    }
+
+    // hashlife advances 2^step generations per call
+    auto start = std::chrono::steady_clock::now();
+    while ( board->getGeneration() < (unsigned long long) options.generations ) {
+        if ( threadPool != nullptr ) {
+            board->createNewGeneration( *threadPool );
+        } else {
+            board->createNewGeneration();
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    double seconds = std::chrono::duration<double>( end - start ).count();
+    double generations = board->getGeneration();
+    double cellUpdates = generations * options.lines * options.columns;
+
+    std::cout << name << ","
+              << options.lines << ","
+              << options.columns << ","
+              << options.threads << ","
+              << ( options.tiles ? "on" : "off" ) << ","
+              << ( options.torus ? "on" : "off" ) << ","
+              << options.pattern << ","
+              << board->getRule().toString() << ","
+              << board->getGeneration() << ","
+              << seconds << ","
+              << generations / seconds << ","
+              << cellUpdates / seconds << ","
+              << getPeakMemory() << std::endl;
+
+    delete board;
+
+    return true;
+
+}
+
+/**
+ * @brief Quotes an argument for the shell used by std::system.
+ */
+static std::string quoteArgument( const std::string &arg ) {
+
+#ifdef _WIN32
+    std::string quoted = "\"";
+    for ( char c : arg ) {
+        if ( c == '"' ) {
+            quoted += "\\";
+        }
+        quoted += c;
+    }
+    return quoted + "\"";
+#else
+    std::string quoted = "'";
+    for ( char c : arg ) {
+        if ( c == '\'' ) {
+            quoted += "'\\''";
+        } else {
+            quoted += c;
+        }
+    }
+    return quoted + "'";
+#endif
+
+}
+
+/**
+ * @brief Returns the command line that runs this program again with the
+ * same options, but only for the board name and without the header.
+ */
+static std::string createBoardCommand( int argc, char **argv, const std::string &name ) {
+
+    std::string command = quoteArgument( argv[0] );
+
+    for ( int i = 1; i < argc; i++ ) {
+        std::string arg = argv[i];
+        if ( ( arg == "--board" || arg == "--header" ) && i + 1 < argc ) {
+            i++;
+        } else {
+            command += " " + quoteArgument( arg );
+        }
+    }
+
+    command += " --board " + name + " --header off";
+
+#ifdef _WIN32
+    // cmd.exe strips the first and the last quote of the command
+    command = "\"" + command + "\"";
+#endif
+
+    return command;
+
+}
+
+bool isBenchmarkMode( int argc, char **argv ) {
+    for ( int i = 1; i < argc; i++ ) {
+        if ( std::strcmp( argv[i], "--benchmark" ) == 0 ) {
+            return true;
+        }
+    }
+    return false;
+}
+
+int runBenchmark( int argc, char **argv ) {
+
+    BenchmarkOptions options;
+    if ( !parseOptions( argc, argv, options ) ) {
+        return 1;
+    }
+
+    if ( options.header ) {
+        std::cout << "board,lines,columns,threads,tiles,torus,pattern,rule,generations,seconds,"
+                  << "generations_per_second,cell_updates_per_second,peak_memory_kb" << std::endl;
+    }
+
+    // the peak memory of a process never goes down, so each board runs in
+    // a process of its own and its peak is not the one of the previous board
+    if ( options.board == "all" ) {
+        int exitCode = 0;
+        for ( const char *name : { "array", "bit", "hashlife" } ) {
+            std::cout.flush();
+            if ( std::system( createBoardCommand( argc, argv, name ).c_str() ) != 0 ) {
+                exitCode = 1;
+            }
+        }
+        return exitCode;
+    }
+
+    ThreadPool *threadPool = options.threads > 1 ? new ThreadPool( options.threads ) : nullptr;
+    bool ok = runBoardBenchmark( options.board, options, threadPool );
+    delete threadPool;
+
+    return ok ? 0 : 1;
+
+}
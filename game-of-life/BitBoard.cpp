@@ -0,0 +1,360 @@
+/**
+ * @file BitBoard.cpp
+ * @author Prof. Dr. David Buzatto
+ * @brief BitBoard class implementation.
+ * 
+ * The bit j of the word k of a line stores the cell of column 64*k+j.
+ * To compute a new generation, the eight neighbors of each cell are
+ * obtained by shifting the words of the line above, the line itself and
+ * the line below one bit to each side, and then they are summed with
+ * full and half adders working on 64 cells in parallel. The sums are
+ * four bit planes (ones, twos, fours and eights) and the rule selects,
+ * for each neighbor count, the dead cells that are born and the live
+ * cells that survive.
+ * 
+ * Each stored line has wordsPerLine + 2 words: the word 0 is a ghost
+ * whose bit 63 plays the role of column -1 and the last one is a ghost
+ * whose bit 0 plays the role of the column after the last full word.
+ * When the number of columns is not a multiple of 64, the first unused
+ * bit of the last real word plays that role instead. The lines 0 and
+ * lines + 1 of the storage are the halo above and below the board.
+ * 
+ * @copyright Copyright (c) 2024
+ */
+#include <BitBoard.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <LifeRule.h>
+
+// one word wide and 32 lines tall
+static const int TILE_HEIGHT = 32;
+static const int TILE_WIDTH = 64;
+
+BitBoard::BitBoard( int lines, int columns ) :
+    GridBoard( lines, columns, TILE_HEIGHT, TILE_WIDTH ) {
+
+    wordsPerLine = ( columns + 63 ) / 64;
+    paddedWords = wordsPerLine + 2;
+    
+    int lastBits = columns % 64;
+    lastWordMask = lastBits == 0 ? ~0ULL : ( 1ULL << lastBits ) - 1;
+
+    int size = ( lines + 2 ) * paddedWords;
+    words = new uint64_t[size];
+    newWords = new uint64_t[size];
+
+    std::fill_n( words, size, 0 );
+    std::fill_n( newWords, size, 0 );
+
+    selectTileKernel();
+
+}
+
+BitBoard::~BitBoard() {
+    delete[] words;
+    delete[] newWords;
+}
+
+/**
+ * @brief The number of live neighbors of 64 cells, as four bit planes.
+ */
+struct NeighborCounts {
+    uint64_t cells;
+    uint64_t ones;
+    uint64_t twos;
+    uint64_t fours;
+    uint64_t eights;
+};
+
+/**
+ * @brief Counts the neighbors of the cells of the word current, whose
+ * line is stored paddedWords words after the line above.
+ */
+static inline NeighborCounts countNeighbors( const uint64_t *current, int paddedWords ) {
+
+    const uint64_t *above = current - paddedWords;
+    const uint64_t *below = current + paddedWords;
+
+    uint64_t a = above[0];
+    uint64_t c = current[0];
+    uint64_t b = below[0];
+
+    // west neighbors (column - 1) and east neighbors (column + 1)
+    uint64_t aw = ( a << 1 ) | ( above[-1] >> 63 );
+    uint64_t ae = ( a >> 1 ) | ( above[1] << 63 );
+    uint64_t cw = ( c << 1 ) | ( current[-1] >> 63 );
+    uint64_t ce = ( c >> 1 ) | ( current[1] << 63 );
+    uint64_t bw = ( b << 1 ) | ( below[-1] >> 63 );
+    uint64_t be = ( b >> 1 ) | ( below[1] << 63 );
+
+    // line above and line below: full adders (sum weight 1, carry weight 2)
+    uint64_t aSum = aw ^ a ^ ae;
+    uint64_t aCarry = ( aw & a ) | ( ae & ( aw ^ a ) );
+    uint64_t bSum = bw ^ b ^ be;
+    uint64_t bCarry = ( bw & b ) | ( be & ( bw ^ b ) );
+
+    // current line: half adder
+    uint64_t cSum = cw ^ ce;
+    uint64_t cCarry = cw & ce;
+
+    // weight 1 bits
+    uint64_t ones = aSum ^ bSum ^ cSum;
+    uint64_t onesCarry = ( aSum & bSum ) | ( cSum & ( aSum ^ bSum ) );
+
+    // weight 2 bits (four inputs)
+    uint64_t t = aCarry ^ bCarry ^ cCarry;
+    uint64_t tCarry = ( aCarry & bCarry ) | ( cCarry & ( aCarry ^ bCarry ) );
+    uint64_t twos = t ^ onesCarry;
+    uint64_t twosCarry = t & onesCarry;
+
+    // weight 4 and weight 8 bits
+    uint64_t fours = tCarry ^ twosCarry;
+    uint64_t eights = tCarry & twosCarry;
+
+    return { c, ones, twos, fours, eights };
+
+}
+
+/**
+ * @brief Returns the cells that have exactly n live neighbors.
+ */
+static inline uint64_t withNeighbors( const NeighborCounts &counts, unsigned int n ) {
+    return ~( counts.ones ^ -(uint64_t) ( n & 1 ) ) &
+           ~( counts.twos ^ -(uint64_t) ( ( n >> 1 ) & 1 ) ) &
+           ~( counts.fours ^ -(uint64_t) ( ( n >> 2 ) & 1 ) ) &
+           ~( counts.eights ^ -(uint64_t) ( ( n >> 3 ) & 1 ) );
+}
+
+/**
+ * @brief Returns the cells with N live neighbors that are alive in the
+ * next generation. Since BIRTH, SURVIVAL and N are constants, the counts
+ * that are not part of the rule are removed by the compiler.
+ */
+template<unsigned int BIRTH, unsigned int SURVIVAL, unsigned int N>
+static inline uint64_t nextForCount( const NeighborCounts &counts ) {
+    uint64_t born = ( ( BIRTH >> N ) & 1 ) ? ~counts.cells : 0;
+    uint64_t survive = ( ( SURVIVAL >> N ) & 1 ) ? counts.cells : 0;
+    return ( born | survive ) & withNeighbors( counts, N );
+}
+
+template<unsigned int BIRTH, unsigned int SURVIVAL, unsigned int... N>
+static inline uint64_t applyRule( const NeighborCounts &counts, std::integer_sequence<unsigned int, N...> ) {
+    return ( nextForCount<BIRTH, SURVIVAL, N>( counts ) | ... );
+}
+
+template<unsigned int BIRTH, unsigned int SURVIVAL>
+static inline uint64_t applyRule( const NeighborCounts &counts ) {
+    return applyRule<BIRTH, SURVIVAL>( counts, std::make_integer_sequence<unsigned int, 9>() );
+}
+
+/**
+ * @brief B3/S23: exactly 2 or 3 neighbors (2 only for live cells), with
+ * the bit planes of 8 or more neighbors reduced to two tests.
+ */
+template<>
+inline uint64_t applyRule<CONWAY_BIRTH, CONWAY_SURVIVAL>( const NeighborCounts &counts ) {
+    return counts.twos & ~counts.fours & ~counts.eights & ( counts.ones | counts.cells );
+}
+
+bool BitBoard::createNewTile( int tileLine, int tileColumn ) {
+    return ( this->*tileKernel )( tileLine, tileColumn );
+}
+
+/**
+ * @brief Selects a kernel specialized at compile time if the rule is one
+ * of the common ones or the table driven kernel otherwise.
+ */
+void BitBoard::selectTileKernel() {
+
+    static const struct {
+        unsigned int birth;
+        unsigned int survival;
+        TileKernel kernel;
+    } KERNELS[] = {
+        { CONWAY_BIRTH, CONWAY_SURVIVAL, 
+          &BitBoard::createNewTileWithRule<CONWAY_BIRTH, CONWAY_SURVIVAL> },
+        { HIGHLIFE_BIRTH, HIGHLIFE_SURVIVAL, 
+          &BitBoard::createNewTileWithRule<HIGHLIFE_BIRTH, HIGHLIFE_SURVIVAL> },
+        { DAY_AND_NIGHT_BIRTH, DAY_AND_NIGHT_SURVIVAL, 
+          &BitBoard::createNewTileWithRule<DAY_AND_NIGHT_BIRTH, DAY_AND_NIGHT_SURVIVAL> },
+        { SEEDS_BIRTH, SEEDS_SURVIVAL, 
+          &BitBoard::createNewTileWithRule<SEEDS_BIRTH, SEEDS_SURVIVAL> },
+        { LIFE_WITHOUT_DEATH_BIRTH, LIFE_WITHOUT_DEATH_SURVIVAL, 
+          &BitBoard::createNewTileWithRule<LIFE_WITHOUT_DEATH_BIRTH, LIFE_WITHOUT_DEATH_SURVIVAL> },
+        { MORLEY_BIRTH, MORLEY_SURVIVAL, 
+          &BitBoard::createNewTileWithRule<MORLEY_BIRTH, MORLEY_SURVIVAL> },
+        { REPLICATOR_BIRTH, REPLICATOR_SURVIVAL, 
+          &BitBoard::createNewTileWithRule<REPLICATOR_BIRTH, REPLICATOR_SURVIVAL> }
+    };
+
+    for ( int n = 0; n <= 8; n++ ) {
+        birthWords[n] = -(uint64_t) ( ( rule.getBirth() >> n ) & 1 );
+        survivalWords[n] = -(uint64_t) ( ( rule.getSurvival() >> n ) & 1 );
+    }
+
+    tileKernel = &BitBoard::createNewTileWithTable;
+
+    for ( const auto &entry : KERNELS ) {
+        if ( entry.birth == rule.getBirth() && entry.survival == rule.getSurvival() ) {
+            tileKernel = entry.kernel;
+        }
+    }
+
+}
+
+template<unsigned int BIRTH, unsigned int SURVIVAL>
+bool BitBoard::createNewTileWithRule( int tileLine, int tileColumn ) {
+    return createNewTileWords( tileLine, tileColumn, []( const NeighborCounts &counts ) {
+        return applyRule<BIRTH, SURVIVAL>( counts );
+    });
+}
+
+bool BitBoard::createNewTileWithTable( int tileLine, int tileColumn ) {
+    return createNewTileWords( tileLine, tileColumn, [this]( const NeighborCounts &counts ) {
+        uint64_t next = 0;
+        for ( int n = 0; n <= 8; n++ ) {
+            uint64_t candidates = ( ~counts.cells & birthWords[n] ) | ( counts.cells & survivalWords[n] );
+            next |= candidates & withNeighbors( counts, n );
+        }
+        return next;
+    });
+}
+
+/**
+ * @brief Computes the words of one tile (one word wide), where
+ * nextWord( counts ) returns the next generation of a word.
+ */
+template<typename NextWord>
+bool BitBoard::createNewTileWords( int tileLine, int tileColumn, NextWord nextWord ) {
+
+    int startLine = tileLine * tileHeight;
+    int endLine = std::min( startLine + tileHeight, lines );
+    int k = tileColumn;
+    bool changed = false;
+
+    // the unused bits of the last word must stay dead
+    uint64_t mask = k == wordsPerLine - 1 ? lastWordMask : ~0ULL;
+
+    for ( int i = startLine; i < endLine; i++ ) {
+        const uint64_t *current = lineWords( words, i ) + k;
+        uint64_t next = nextWord( countNeighbors( current, paddedWords ) ) & mask;
+        changed |= next != ( *current & mask );
+        lineWords( newWords, i )[k] = next;
+    }
+
+    return changed;
+
+}
+
+void BitBoard::swapGenerations() {
+    std::swap( words, newWords );
+}
+
+uint64_t BitBoard::hashTile( int tileLine, int tileColumn ) const {
+
+    int startLine = tileLine * tileHeight;
+    int endLine = std::min( startLine + tileHeight, lines );
+    uint64_t mask = tileColumn == wordsPerLine - 1 ? lastWordMask : ~0ULL;
+    uint64_t hash = 0;
+
+    for ( int i = startLine; i < endLine; i++ ) {
+        hash = mixHash( hash, lineWords( words, i )[tileColumn] & mask );
+    }
+
+    return hash;
+
+}
+
+/**
+ * @brief Fills the ghost words, the unused bits of the last word and the
+ * halo lines with the opposite edges of the board when it is toroidal or
+ * with dead cells otherwise.
+ */
+void BitBoard::refreshHalo() {
+
+    int lastBits = columns % 64;
+
+    for ( int i = 0; i < lines; i++ ) {
+
+        uint64_t *line = lineWords( words, i );
+        uint64_t first = torus ? line[0] & 1 : 0;
+        uint64_t last = torus ? ( line[( columns - 1 ) / 64] >> ( ( columns - 1 ) % 64 ) ) & 1 : 0;
+
+        line[-1] = last << 63;
+        line[wordsPerLine-1] &= lastWordMask;
+        if ( lastBits == 0 ) {
+            line[wordsPerLine] = first;
+        } else {
+            line[wordsPerLine-1] |= first << lastBits;
+            line[wordsPerLine] = 0;
+        }
+
+    }
+
+    uint64_t *top = words;
+    uint64_t *bottom = words + ( lines + 1 ) * paddedWords;
+
+    if ( torus ) {
+        std::copy_n( words + lines * paddedWords, paddedWords, top );
+        std::copy_n( words + paddedWords, paddedWords, bottom );
+    } else {
+        std::fill_n( top, paddedWords, 0 );
+        std::fill_n( bottom, paddedWords, 0 );
+    }
+
+}
+
+/**
+ * @brief Returns the first real word of a line, skipping the halo line
+ * and the ghost word.
+ */
+uint64_t *BitBoard::lineWords( uint64_t *buffer, int line ) const {
+    return buffer + ( line + 1 ) * paddedWords + 1;
+}
+
+const uint64_t *BitBoard::lineWords( const uint64_t *buffer, int line ) const {
+    return buffer + ( line + 1 ) * paddedWords + 1;
+}
+
+bool BitBoard::getCell( int line, int column ) const {
+    return ( lineWords( words, line )[column/64] >> ( column % 64 ) ) & 1;
+}
+
+void BitBoard::setCell( int line, int column, bool alive ) {
+    uint64_t bit = 1ULL << ( column % 64 );
+    uint64_t *word = lineWords( words, line ) + column/64;
+    if ( alive ) {
+        *word |= bit;
+    } else {
+        *word &= ~bit;
+    }
+    wakeTilesAround( line, column );
+}
+
+void BitBoard::clear() {
+    std::fill_n( words, ( lines + 2 ) * paddedWords, 0 );
+    wakeAllTiles();
+}
+
+void BitBoard::readRegion( int line, int column, int height, int width, unsigned char *cells ) const {
+
+    if ( line < 0 || column < 0 || line + height > lines || column + width > columns ) {
+        LifeBoard::readRegion( line, column, height, width, cells );
+        return;
+    }
+
+    for ( int i = 0; i < height; i++ ) {
+        const uint64_t *source = lineWords( words, line + i );
+        for ( int j = 0; j < width; j++ ) {
+            int c = column + j;
+            cells[i*width+j] = ( source[c/64] >> ( c % 64 ) ) & 1;
+        }
+    }
+
+}
+
+const char *BitBoard::getName() const {
+    return "64 células por palavra";
+}
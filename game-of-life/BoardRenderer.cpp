@@ -0,0 +1,130 @@
+/**
+ * @file BoardRenderer.cpp
+ * @author Prof. Dr. David Buzatto
+ * @brief BoardRenderer class implementation.
+ * 
+ * @copyright Copyright (c) 2024
+ */
+#include <BoardRenderer.h>
+
+#include <vector>
+#include <raylib.h>
+
+BoardRenderer::BoardRenderer( int size ) :
+    size( size ),
+    cellsTexture{},
+    visibleCells( 0 ) {
+}
+
+BoardRenderer::~BoardRenderer() {
+}
+
+void BoardRenderer::update( const std::vector<unsigned char> &boardCells, int columns, 
+                            int startLine, int startColumn, int visibleCells ) {
+
+    if ( cellsTexture.id == 0 ) {
+        Image image = GenImageColor( size, size, WHITE );
+        cellsTexture = LoadTextureFromImage( image );
+        UnloadImage( image );
+    }
+
+    this->visibleCells = visibleCells;
+    pixels.resize( visibleCells * visibleCells );
+
+    for ( int i = 0; i < visibleCells; i++ ) {
+        const unsigned char *source = boardCells.data() + ( startLine + i ) * columns + startColumn;
+        for ( int j = 0; j < visibleCells; j++ ) {
+            pixels[i*visibleCells+j] = source[j] ? BLACK : WHITE;
+        }
+    }
+
+    UpdateTextureRec( cellsTexture, { 0, 0, (float) visibleCells, (float) visibleCells }, pixels.data() );
+
+}
+
+void BoardRenderer::draw( int zoom, int cellWidth, bool drawGrid ) const {
+
+    if ( cellsTexture.id == 0 ) {
+        return;
+    }
+
+    DrawTexturePro( 
+        cellsTexture, 
+        { 0, 0, (float) visibleCells, (float) visibleCells }, 
+        { 0, 0, (float) visibleCells * cellWidth, (float) visibleCells * cellWidth }, 
+        { 0, 0 }, 0, WHITE );
+
+    if ( drawGrid && zoom < (int) gridTextures.size() && gridTextures[zoom].id != 0 ) {
+
+        const RenderTexture2D &grid = gridTextures[zoom];
+
+        // render textures are stored upside down
+        DrawTextureRec( grid.texture, 
+                        { 0, 0, (float) grid.texture.width, (float) -grid.texture.height }, 
+                        { 0, 0 }, WHITE );
+
+    }
+
+}
+
+void BoardRenderer::unloadTextures() {
+
+    if ( cellsTexture.id != 0 ) {
+        UnloadTexture( cellsTexture );
+        cellsTexture = {};
+    }
+
+    for ( RenderTexture2D &grid : gridTextures ) {
+        if ( grid.id != 0 ) {
+            UnloadRenderTexture( grid );
+        }
+    }
+
+    gridTextures.clear();
+    gridCellWidths.clear();
+
+}
+
+void BoardRenderer::prepareGrid( int zoom, int cellWidth ) {
+
+    if ( (int) gridTextures.size() <= zoom ) {
+        gridTextures.resize( zoom + 1, RenderTexture2D{} );
+        gridCellWidths.resize( zoom + 1, 0 );
+    }
+
+    if ( gridTextures[zoom].id != 0 && gridCellWidths[zoom] == cellWidth ) {
+        return;
+    }
+
+    if ( gridTextures[zoom].id != 0 ) {
+        UnloadRenderTexture( gridTextures[zoom] );
+    }
+
+    RenderTexture2D grid = LoadRenderTexture( size, size );
+    int count = size / cellWidth;
+
+    BeginTextureMode( grid );
+    ClearBackground( BLANK );
+
+    for ( int i = 1; i < count; i++ ) {
+        if ( i % 10 == 0 ) {
+            DrawLine( 0, i * cellWidth, size, i * cellWidth, BLACK );
+        } else {
+            DrawLine( 0, i * cellWidth, size, i * cellWidth, GRAY );
+        }
+    }
+
+    for ( int i = 1; i < count; i++ ) {
+        if ( i % 10 == 0 ) {
+            DrawLine( i * cellWidth, 0, i * cellWidth, size, BLACK );
+        } else {
+            DrawLine( i * cellWidth, 0, i * cellWidth, size, GRAY );
+        }
+    }
+
+    EndTextureMode();
+
+    gridTextures[zoom] = grid;
+    gridCellWidths[zoom] = cellWidth;
+
+}
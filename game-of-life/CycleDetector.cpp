@@ -0,0 +1,53 @@
+/**
+ * @file CycleDetector.cpp
+ * @author Prof. Dr. David Buzatto
+ * @brief CycleDetector class implementation.
+ * 
+ * @copyright Copyright (c) 2024
+ */
+#include <CycleDetector.h>
+
+#include <cstdint>
+#include <vector>
+
+CycleDetector::CycleDetector( int maxPeriod ) :
+    hashes( maxPeriod, 0 ),
+    count( 0 ),
+    next( 0 ) {
+}
+
+void CycleDetector::clear() {
+    count = 0;
+    next = 0;
+}
+
+bool CycleDetector::isEmpty() const {
+    return count == 0;
+}
+
+int CycleDetector::add( uint64_t hash ) {
+
+    int size = (int) hashes.size();
+    int period = 0;
+
+    // from the most recent generation to the oldest one
+    for ( int p = 1; p <= count; p++ ) {
+        if ( hashes[( next - p + size ) % size] == hash ) {
+            period = p;
+            break;
+        }
+    }
+
+    hashes[next] = hash;
+    next = ( next + 1 ) % size;
+    if ( count < size ) {
+        count++;
+    }
+
+    return period;
+
+}
+
+int CycleDetector::getMaxPeriod() const {
+    return (int) hashes.size();
+}
@@ -54,4 +54,8 @@ void GameWindow::init() {
 
     CloseWindow();
 
-}
\ No newline at end of file
+}
+
+void GameWindow::loadPattern( const std::string &path ) {
+    gw.loadPattern( path );
+}
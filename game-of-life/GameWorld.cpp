@@ -16,9 +16,14 @@
 #include <cassert>
 #include <algorithm>
 #include <iterator>
+#include <thread>
 #include <raylib.h>
 
 #include <GameState.h>
+#include <BoardType.h>
+#include <Simulation.h>
+#include <LifeRule.h>
+#include <BoardRenderer.h>
 
 /**
  * @brief Construct a new GameWorld object
@@ -26,6 +31,15 @@
 GameWorld::GameWorld() : 
         minCellWidth( 1 ),
         boardWidth( 960 ),
+        boardType( BoardType::BIT_BOARD ),
+        ruleIndex( 0 ),
+        cycleMode( CycleMode::CYCLE_REPLAY ),
+        cycleStops( 0 ),
+        tileTracking( true ),
+        torus( false ),
+        parallelStepping( true ),
+        renderer( boardWidth ),
+        cellsChanged( true ),
         state( GameState::IDLE ) {
 
     loadResources();
@@ -35,39 +49,18 @@ GameWorld::GameWorld() :
     columns = lines;
 
     cellWidth = allowedCellWidths[currentZoom];
-    
-    evolutionArraySize = columns * lines;
-    evolutionArray = new int[evolutionArraySize];
-    resetArray = new int[evolutionArraySize];
-    newGeneration = new int[evolutionArraySize];
 
     drawGrid = true;
-
-    currentTime = 0;
     timeToWait = 0.3;
 
-    std::fill_n( evolutionArray, evolutionArraySize, 0 );
-
-    evolutionArray[454554] = 1;
-    evolutionArray[455513] = 1;
-    evolutionArray[456473] = 1;
-    evolutionArray[456474] = 1;
-    evolutionArray[456475] = 1;
-    evolutionArray[455525] = 1;
-    evolutionArray[454564] = 1;
-    evolutionArray[454563] = 1;
-    evolutionArray[455523] = 1;
-    evolutionArray[456483] = 1;
-    evolutionArray[466084] = 1;
-    evolutionArray[465125] = 1;
-    evolutionArray[464165] = 1;
-    evolutionArray[464164] = 1;
-    evolutionArray[464163] = 1;
-    evolutionArray[465113] = 1;
-    evolutionArray[466074] = 1;
-    evolutionArray[466075] = 1;
-    evolutionArray[465115] = 1;
-    evolutionArray[464155] = 1;
+    int threadCount = std::max( 1, (int) std::thread::hardware_concurrency() );
+    simulation = new Simulation( lines, columns, boardType, threadCount );
+    simulation->setInterval( timeToWait );
+    simulation->setTileTracking( tileTracking );
+    simulation->setTorus( torus );
+    simulation->setParallelStepping( parallelStepping );
+    simulation->setCycleMode( cycleMode );
+    simulation->acquireSnapshot();
 
 }
 
@@ -77,16 +70,21 @@ GameWorld::GameWorld() :
 GameWorld::~GameWorld() {
     unloadResources();
     std::cout << "destroying game world..." << std::endl;
-    delete[] evolutionArray;
-    delete[] newGeneration;
+    delete simulation;
 }
 
 /**
  * @brief Reads user input and updates the state of the game.
+ * 
+ * The generations are created by the simulation thread: this method
+ * only sends commands to it and takes the last finished generation.
  */
 void GameWorld::inputAndUpdate() {
 
     int mw = GetMouseWheelMove();
+    if ( mw != 0 ) {
+        cellsChanged = true;
+    }
     if ( mw > 0 ) {
         currentZoom++;
         if ( currentZoom > MAX_ZOOM ) {
@@ -105,53 +103,67 @@ void GameWorld::inputAndUpdate() {
     startColumn = (columns / 2) - (boardWidth / cellWidth / 2);
     endColumn = startColumn + (boardWidth / cellWidth);
 
+    // zero means as fast as possible
     if ( IsKeyPressed( KEY_UP ) ) {
         timeToWait += 0.05;
         if ( timeToWait > 2.0 ) {
             timeToWait = 2.0;
         }
+        simulation->setInterval( timeToWait );
     } else if ( IsKeyPressed( KEY_DOWN ) ) {
         timeToWait -= 0.05;
-        if ( timeToWait < 0.05 ) {
-            timeToWait = 0.05;
+        if ( timeToWait < 0.025 ) {
+            timeToWait = 0;
         }
+        simulation->setInterval( timeToWait );
     }
 
-    if ( state == GameState::RUNNING && currentTime >= timeToWait ) {
-        createNewGeneration();
-        currentTime = 0;
-    } else {
-        currentTime += GetFrameTime();
+    if ( simulation->acquireSnapshot() ) {
+        cellsChanged = true;
+        // the simulation pauses by itself when it finds a cycle
+        unsigned int stops = simulation->getSnapshot().cycleStops;
+        if ( stops != cycleStops ) {
+            cycleStops = stops;
+            if ( cycleMode == CycleMode::CYCLE_PAUSE && state == GameState::RUNNING ) {
+                state = GameState::PAUSED;
+            }
+        }
     }
 
+    const std::vector<unsigned char> &cells = simulation->getSnapshot().cells;
+
     if ( IsMouseButtonDown( MOUSE_BUTTON_LEFT ) && state != GameState::RUNNING ) {
         int line = GetMouseY() / cellWidth + startLine;
         int column = GetMouseX() / cellWidth + startColumn;
-        if ( evolutionArray[line*columns + column] == 0 ) {
-            evolutionArray[line*columns + column] = 1;
-            //std::cout << "added: " << line*columns+column << std::endl;
+        if ( line >= 0 && line < lines && column >= 0 && column < columns && 
+             !cells[line*columns+column] ) {
+            simulation->setCell( line, column, true );
         }
     } else if ( IsMouseButtonDown( MOUSE_BUTTON_RIGHT ) && state != GameState::RUNNING ) {
         int line = GetMouseY() / cellWidth + startLine;
         int column = GetMouseX() / cellWidth + startColumn;
-        if ( evolutionArray[line*columns + column] == 1 ) {
-            evolutionArray[line*columns + column] = 0;
-            //std::cout << "removed: " << line*columns+column << std::endl;
+        if ( line >= 0 && line < lines && column >= 0 && column < columns && 
+             cells[line*columns+column] ) {
+            simulation->setCell( line, column, false );
         }
     }
 
     if ( IsKeyPressed( KEY_R ) && state != GameState::IDLE ) {
-        std::copy( resetArray, resetArray+evolutionArraySize, evolutionArray );
+        simulation->setRunning( false );
+        simulation->reset();
         state = GameState::IDLE;
     }
 
     if ( IsKeyPressed( KEY_SPACE ) ) {
         if ( state == GameState::IDLE ) {
-            std::copy( evolutionArray, evolutionArray+evolutionArraySize, resetArray );
+            simulation->saveResetCells();
+            simulation->setRunning( true );
             state = GameState::RUNNING;
         } else if ( state == GameState::RUNNING ) {
+            simulation->setRunning( false );
             state = GameState::PAUSED;
         } else if ( state == GameState::PAUSED ) {
+            simulation->setRunning( true );
             state = GameState::RUNNING;
         }
     }
@@ -160,105 +172,145 @@ void GameWorld::inputAndUpdate() {
         drawGrid = !drawGrid;
     }
 
-}
+    if ( IsKeyPressed( KEY_P ) ) {
+        parallelStepping = !parallelStepping;
+        simulation->setParallelStepping( parallelStepping );
+    }
 
-/**
- * @brief Draws the state of the game.
- */
-void GameWorld::draw() const {
+    if ( IsKeyPressed( KEY_A ) ) {
+        tileTracking = !tileTracking;
+        simulation->setTileTracking( tileTracking );
+    }
 
-    BeginDrawing();
-    ClearBackground( WHITE );
+    if ( IsKeyPressed( KEY_L ) ) {
+        ruleIndex = ( ruleIndex + 1 ) % LifeRule::getPresetCount();
+        simulation->setRule( LifeRule::getPreset( ruleIndex ) );
+    }
 
-    for ( int i = startLine; i < endLine; i++ ) {
-        for ( int j = startColumn; j <= endColumn; j++ ) {
-            if ( evolutionArray[i*columns + j] ) {
-                DrawRectangle( 
-                    j * cellWidth - startColumn * cellWidth, 
-                    i * cellWidth - startLine * cellWidth, 
-                    cellWidth, cellWidth, BLACK );
-            }
+    if ( IsKeyPressed( KEY_C ) ) {
+        if ( cycleMode == CycleMode::CYCLE_REPLAY ) {
+            cycleMode = CycleMode::CYCLE_PAUSE;
+        } else if ( cycleMode == CycleMode::CYCLE_PAUSE ) {
+            cycleMode = CycleMode::CYCLE_IGNORE;
+        } else {
+            cycleMode = CycleMode::CYCLE_REPLAY;
         }
+        simulation->setCycleMode( cycleMode );
     }
 
-    if ( drawGrid ) {
-        for ( int i = 1; i < endLine - startLine; i++ ) {
-            if ( i % 10 == 0 ) {
-                DrawLine( 0, i * cellWidth, GetScreenWidth(), i * cellWidth, BLACK );
-            } else {
-                DrawLine( 0, i * cellWidth, GetScreenWidth(), i * cellWidth, GRAY );
-            }
-        }
+    if ( IsKeyPressed( KEY_T ) ) {
+        torus = !torus;
+        simulation->setTorus( torus );
+    }
 
-        for ( int i = 1; i < endColumn - startColumn; i++ ) {
-            if ( i % 10 == 0 ) {
-                DrawLine( i * cellWidth, 0, i * cellWidth, GetScreenHeight(), BLACK );
-            } else {
-                DrawLine( i * cellWidth, 0, i * cellWidth, GetScreenHeight(), GRAY );
-            }
+    if ( boardType == BoardType::HASHLIFE_BOARD ) {
+        if ( IsKeyPressed( KEY_PAGE_UP ) ) {
+            simulation->changeStepExponent( 1 );
+        } else if ( IsKeyPressed( KEY_PAGE_DOWN ) ) {
+            simulation->changeStepExponent( -1 );
         }
     }
 
-    DrawText( TextFormat( "%.2f segundos para a próxima geração.", timeToWait ), 20, 20, 20, BLUE );
-
-    EndDrawing();
-
-}
+    if ( IsFileDropped() ) {
+        FilePathList files = LoadDroppedFiles();
+        if ( files.count > 0 ) {
+            loadPattern( files.paths[0] );
+        }
+        UnloadDroppedFiles( files );
+    }
 
-int GameWorld::getBoardWidth() const {
-    return boardWidth;
-}
+    if ( IsKeyPressed( KEY_S ) ) {
+        simulation->savePattern( IsKeyDown( KEY_LEFT_SHIFT ) ? "tabuleiro.lif" : "tabuleiro.rle" );
+    }
 
-void GameWorld::createNewGeneration() {
-
-    for ( int i = 0; i < lines; i++ ) {
-        for ( int j = 0; j < columns; j++ ) {
-            int p = i*columns+j;
-            int n = countNeighbors( i, j );
-            if ( evolutionArray[p] ) {
-                if ( n <= 1 || n >= 4 ) {
-                    newGeneration[p] = 0;
-                } else {
-                    newGeneration[p] = 1;
-                }
-            } else {
-                if ( n == 3 ) {
-                    newGeneration[p] = 1;
-                } else {
-                    newGeneration[p] = 0;
-                }
-            }
+    if ( IsKeyPressed( KEY_B ) ) {
+        if ( boardType == BoardType::ARRAY_BOARD ) {
+            boardType = BoardType::BIT_BOARD;
+        } else if ( boardType == BoardType::BIT_BOARD ) {
+            boardType = BoardType::HASHLIFE_BOARD;
+        } else {
+            boardType = BoardType::ARRAY_BOARD;
         }
+        simulation->setBoardType( boardType );
+    }
+
+    if ( cellsChanged ) {
+        renderer.update( cells, columns, startLine, startColumn, endLine - startLine );
+        cellsChanged = false;
     }
 
-    std::copy( newGeneration, newGeneration+evolutionArraySize, evolutionArray );
+    if ( drawGrid ) {
+        renderer.prepareGrid( currentZoom, cellWidth );
+    }
 
 }
 
-int GameWorld::countNeighbors( int line, int column ) {
+/**
+ * @brief Draws the state of the game.
+ */
+void GameWorld::draw() const {
+
+    const BoardSnapshot &snapshot = simulation->getSnapshot();
 
-    int count = 0;
+    BeginDrawing();
+    ClearBackground( WHITE );
 
-    for ( int i = line-1; i < line + 2; i++ ) {
-        for ( int j = column-1; j < column + 2; j++ ) {
-            if ( i >= 0 &&
-                 i < lines && 
-                 j >= 0 &&
-                 j < columns &&
-                 evolutionArray[i*columns+j] ) {
-                count++;
-            }
+    renderer.draw( currentZoom, cellWidth, drawGrid );
+
+    if ( timeToWait > 0 ) {
+        DrawText( TextFormat( "%.2f segundos para a próxima geração (%.0f gerações/s).", 
+                              timeToWait, snapshot.generationsPerSecond ), 20, 20, 20, BLUE );
+    } else {
+        DrawText( TextFormat( "sem espera entre gerações (%.0f gerações/s).", 
+                              snapshot.generationsPerSecond ), 20, 20, 20, BLUE );
+    }
+    DrawText( TextFormat( "tabuleiro: %s (B para alternar)", snapshot.boardName ), 20, 45, 20, BLUE );
+    DrawText( TextFormat( "regra: %s %s (L para alternar)", 
+                          snapshot.rule.toString().c_str(), snapshot.rule.getName() ), 20, 70, 20, BLUE );
+    if ( parallelStepping ) {
+        DrawText( TextFormat( "%d threads (P para alternar)", simulation->getThreadCount() ), 20, 95, 20, BLUE );
+    } else {
+        DrawText( "1 thread (P para alternar)", 20, 95, 20, BLUE );
+    }
+    DrawText( TextFormat( "geração: %llu", snapshot.generation ), 20, 120, 20, BLUE );
+    if ( snapshot.gridBoard ) {
+        DrawText( TextFormat( "tiles ativos: %d de %d (A para %s)", 
+                              snapshot.activeTileCount, snapshot.tileCount,
+                              tileTracking ? "desativar" : "ativar" ), 20, 145, 20, BLUE );
+        DrawText( TextFormat( "bordas: %s (T para alternar)", 
+                              torus ? "toroidais" : "fechadas" ), 20, 170, 20, BLUE );
+        const char *mode = cycleMode == CycleMode::CYCLE_REPLAY ? "repetir" : 
+                           cycleMode == CycleMode::CYCLE_PAUSE ? "pausar" : "ignorar";
+        if ( snapshot.cyclePeriod > 0 ) {
+            DrawText( TextFormat( "ciclo de período %d desde a geração %llu%s (C: %s)", 
+                                  snapshot.cyclePeriod, snapshot.cycleStart, 
+                                  snapshot.replaying ? ", repetindo" : "", mode ), 20, 195, 20, BLUE );
+        } else {
+            DrawText( TextFormat( "ciclos: %s (C para alternar)", mode ), 20, 195, 20, BLUE );
         }
     }
-
-    if ( evolutionArray[line*columns+column] ) {
-        count--;
+    if ( snapshot.hashLife ) {
+        DrawText( TextFormat( "2^%d gerações por passo (Page Up/Page Down), %.0f células, %zu nós", 
+                              snapshot.stepExponent, snapshot.population, snapshot.nodeCount ), 20, 145, 20, BLUE );
     }
 
-    return count;
+    EndDrawing();
 
 }
 
+/**
+ * @brief Replaces the board with the pattern stored in a RLE or Life 1.06
+ * file, going back to the idle state.
+ */
+void GameWorld::loadPattern( const std::string &path ) {
+    simulation->loadPattern( path );
+    state = GameState::IDLE;
+}
+
+int GameWorld::getBoardWidth() const {
+    return boardWidth;
+}
+
 /**
  * @brief Load game resources like images, textures, sounds, fonts, shaders etc.
  * Should be called inside the constructor.
@@ -273,4 +325,9 @@ void GameWorld::loadResources() {
  */
 void GameWorld::unloadResources() {
     std::cout << "unloading resources..." << std::endl;
+    // the textures are released with the OpenGL context when the window
+    // was already closed
+    if ( IsWindowReady() ) {
+        renderer.unloadTextures();
+    }
 }
\ No newline at end of file
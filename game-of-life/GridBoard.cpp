@@ -0,0 +1,188 @@
+/**
+ * @file GridBoard.cpp
+ * @author Prof. Dr. David Buzatto
+ * @brief GridBoard class implementation.
+ * 
+ * @copyright Copyright (c) 2024
+ */
+#include <GridBoard.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+#include <ThreadPool.h>
+#include <LifeRule.h>
+
+GridBoard::GridBoard( int lines, int columns, int tileHeight, int tileWidth ) :
+    LifeBoard( lines, columns ),
+    tileHeight( tileHeight ),
+    tileWidth( tileWidth ),
+    torus( false ),
+    activeTileCount( 0 ),
+    tileTracking( true ),
+    hash( 0 ) {
+
+    tileLines = ( lines + tileHeight - 1 ) / tileHeight;
+    tileColumns = ( columns + tileWidth - 1 ) / tileWidth;
+
+    activeTiles.assign( tileLines * tileColumns, 1 );
+    changedTiles.assign( tileLines * tileColumns, 0 );
+    tileHashes.assign( tileLines * tileColumns, 0 );
+    staleHashes.assign( tileLines * tileColumns, 1 );
+
+}
+
+GridBoard::~GridBoard() {
+}
+
+void GridBoard::createNewGeneration() {
+    refreshHalo();
+    createNewTileLines( 0, tileLines );
+    swapGenerations();
+    updateActiveTiles();
+    generation++;
+}
+
+void GridBoard::createNewGeneration( ThreadPool &threadPool ) {
+
+    refreshHalo();
+
+    threadPool.run( tileLines, [this]( int tileLine ) {
+        createNewTileLines( tileLine, tileLine + 1 );
+    });
+
+    swapGenerations();
+    updateActiveTiles();
+    generation++;
+
+}
+
+void GridBoard::setTileTracking( bool tileTracking ) {
+    this->tileTracking = tileTracking;
+}
+
+bool GridBoard::isTileTracking() const {
+    return tileTracking;
+}
+
+bool GridBoard::setRule( const LifeRule &rule ) {
+    LifeBoard::setRule( rule );
+    selectTileKernel();
+    wakeAllTiles();
+    return true;
+}
+
+void GridBoard::setTorus( bool torus ) {
+    if ( this->torus != torus ) {
+        this->torus = torus;
+        wakeAllTiles();
+    }
+}
+
+bool GridBoard::isTorus() const {
+    return torus;
+}
+
+uint64_t GridBoard::getHash() {
+
+    for ( int i = 0; i < tileLines; i++ ) {
+        for ( int j = 0; j < tileColumns; j++ ) {
+            int p = i * tileColumns + j;
+            if ( staleHashes[p] ) {
+                hash -= tileHashes[p];
+                // the position is part of the hash, so equal tiles in
+                // different places do not cancel each other
+                tileHashes[p] = mixHash( hashTile( i, j ), p );
+                hash += tileHashes[p];
+                staleHashes[p] = 0;
+            }
+        }
+    }
+
+    return hash;
+
+}
+
+uint64_t GridBoard::mixHash( uint64_t hash, uint64_t value ) {
+    hash ^= value + 0x9E3779B97F4A7C15ULL + ( hash << 6 ) + ( hash >> 2 );
+    hash *= 0xBF58476D1CE4E5B9ULL;
+    return hash ^ ( hash >> 31 );
+}
+
+int GridBoard::getActiveTileCount() const {
+    return activeTileCount;
+}
+
+int GridBoard::getTileCount() const {
+    return tileLines * tileColumns;
+}
+
+void GridBoard::wakeTilesAround( int line, int column ) {
+    staleHashes[( line / tileHeight ) * tileColumns + column / tileWidth] = 1;
+    wakeTilesAroundTile( line / tileHeight, column / tileWidth );
+}
+
+void GridBoard::wakeAllTiles() {
+    std::fill( activeTiles.begin(), activeTiles.end(), 1 );
+    std::fill( staleHashes.begin(), staleHashes.end(), 1 );
+}
+
+void GridBoard::createNewTileLines( int startTileLine, int endTileLine ) {
+    for ( int i = startTileLine; i < endTileLine; i++ ) {
+        for ( int j = 0; j < tileColumns; j++ ) {
+            int p = i * tileColumns + j;
+            changedTiles[p] = activeTiles[p] && createNewTile( i, j );
+        }
+    }
+}
+
+/**
+ * @brief The tiles of the next generation are the ones that changed in
+ * this generation and their neighbors.
+ */
+void GridBoard::updateActiveTiles() {
+
+    activeTileCount = std::count( activeTiles.begin(), activeTiles.end(), 1 );
+
+    for ( size_t p = 0; p < changedTiles.size(); p++ ) {
+        staleHashes[p] |= changedTiles[p];
+    }
+
+    if ( !tileTracking ) {
+        std::fill( activeTiles.begin(), activeTiles.end(), 1 );
+        return;
+    }
+
+    std::fill( activeTiles.begin(), activeTiles.end(), 0 );
+
+    for ( int i = 0; i < tileLines; i++ ) {
+        for ( int j = 0; j < tileColumns; j++ ) {
+            if ( changedTiles[i*tileColumns+j] ) {
+                wakeTilesAroundTile( i, j );
+            }
+        }
+    }
+
+}
+
+/**
+ * @brief Wakes a tile and its eight neighbors, wrapping around the edges
+ * of a toroidal board.
+ */
+void GridBoard::wakeTilesAroundTile( int tileLine, int tileColumn ) {
+
+    for ( int i = tileLine - 1; i <= tileLine + 1; i++ ) {
+        for ( int j = tileColumn - 1; j <= tileColumn + 1; j++ ) {
+            int k = i;
+            int l = j;
+            if ( torus ) {
+                k = ( k + tileLines ) % tileLines;
+                l = ( l + tileColumns ) % tileColumns;
+            } else if ( k < 0 || k >= tileLines || l < 0 || l >= tileColumns ) {
+                continue;
+            }
+            activeTiles[k*tileColumns+l] = 1;
+        }
+    }
+
+}
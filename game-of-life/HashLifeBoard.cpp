@@ -0,0 +1,620 @@
+/**
+ * @file HashLifeBoard.cpp
+ * @author Prof. Dr. David Buzatto
+ * @brief HashLifeBoard class implementation.
+ * 
+ * Based on https://en.wikipedia.org/wiki/Hashlife
+ * 
+ * @copyright Copyright (c) 2024
+ */
+#include <HashLifeBoard.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+static const size_t NODES_PER_BLOCK = 1 << 16;
+static const int MAX_STEP_EXPONENT = 48;
+static const int MIN_ROOT_LEVEL = 3;
+
+HashLifeBoard::HashLifeBoard( int lines, int columns, size_t maxNodes ) :
+    LifeBoard( lines, columns ),
+    freeNodes( nullptr ),
+    nodeCount( 0 ),
+    maxNodes( maxNodes ),
+    stepExponent( 0 ) {
+
+    hashTable.assign( 1 << 16, nullptr );
+
+    deadCell = allocateNode();
+    *deadCell = { nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, 0, 0, -1, false };
+    liveCell = allocateNode();
+    *liveCell = { nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, 1, 0, -1, false };
+
+    emptyNodes.push_back( deadCell );
+    root = emptyNode( MIN_ROOT_LEVEL );
+
+}
+
+HashLifeBoard::~HashLifeBoard() {
+    for ( Node *block : blocks ) {
+        delete[] block;
+    }
+}
+
+void HashLifeBoard::createNewGeneration() {
+
+    // the pattern must lie in the center quarter of the root and one more
+    // expansion is needed, so nothing can escape the center half (the
+    // successor) in 2^stepExponent generations
+    while ( root->level < stepExponent + 2 || !isPaddedForStep( root ) ) {
+        root = expand( root );
+    }
+    root = expand( root );
+
+    root = successor( root, stepExponent );
+    generation += 1ULL << stepExponent;
+
+    while ( root->level < MIN_ROOT_LEVEL ) {
+        root = expand( root );
+    }
+
+    if ( nodeCount > maxNodes ) {
+        collectGarbage( true );
+        if ( nodeCount > maxNodes / 2 ) {
+            collectGarbage( false );
+        }
+    }
+
+}
+
+bool HashLifeBoard::getCell( int line, int column ) const {
+
+    int64_t x;
+    int64_t y;
+    toUniverse( line, column, x, y );
+
+    int64_t half = 1LL << ( root->level - 1 );
+    x += half;
+    y += half;
+
+    if ( x < 0 || y < 0 || x >= 2 * half || y >= 2 * half ) {
+        return false;
+    }
+
+    return getCell( root, x, y );
+
+}
+
+void HashLifeBoard::setCell( int line, int column, bool alive ) {
+
+    int64_t x;
+    int64_t y;
+    toUniverse( line, column, x, y );
+
+    while ( x < -( 1LL << ( root->level - 1 ) ) || x >= ( 1LL << ( root->level - 1 ) ) ||
+            y < -( 1LL << ( root->level - 1 ) ) || y >= ( 1LL << ( root->level - 1 ) ) ) {
+        root = expand( root );
+    }
+
+    int64_t half = 1LL << ( root->level - 1 );
+    root = setCell( root, x + half, y + half, alive );
+
+}
+
+void HashLifeBoard::clear() {
+    root = emptyNode( MIN_ROOT_LEVEL );
+    collectGarbage( false );
+}
+
+void HashLifeBoard::readRegion( int line, int column, int height, int width, unsigned char *cells ) const {
+
+    std::fill_n( cells, height * width, 0 );
+
+    int64_t x;
+    int64_t y;
+    toUniverse( line, column, x, y );
+
+    // top left corner of the root relative to the region
+    int64_t half = 1LL << ( root->level - 1 );
+    readRegion( root, -half - x, -half - y, height, width, cells );
+
+}
+
+bool HashLifeBoard::getLiveBounds( long long &top, long long &left, long long &bottom, long long &right ) const {
+
+    bool found = false;
+    int64_t minX = 0;
+    int64_t minY = 0;
+    int64_t maxX = 0;
+    int64_t maxY = 0;
+
+    int64_t half = 1LL << ( root->level - 1 );
+    findLiveBounds( root, -half, -half, found, minX, minY, maxX, maxY );
+
+    // from the universe to the board
+    top = minY + lines / 2;
+    left = minX + columns / 2;
+    bottom = maxY + lines / 2;
+    right = maxX + columns / 2;
+
+    return found;
+
+}
+
+/**
+ * @brief Changes the rule, forgetting the memoized successors. Rules
+ * where cells are born without neighbors are not supported, since the
+ * empty space of the universe would not stay empty.
+ */
+bool HashLifeBoard::setRule( const LifeRule &rule ) {
+
+    if ( rule.hasBirthOnZero() ) {
+        return false;
+    }
+
+    if ( !( rule == this->rule ) ) {
+        LifeBoard::setRule( rule );
+        collectGarbage( false );
+    }
+
+    return true;
+
+}
+
+bool HashLifeBoard::isInside( int line, int column ) const {
+    return true;
+}
+
+const char *HashLifeBoard::getName() const {
+    return "HashLife";
+}
+
+void HashLifeBoard::setStepExponent( int stepExponent ) {
+    this->stepExponent = std::clamp( stepExponent, 0, MAX_STEP_EXPONENT );
+}
+
+int HashLifeBoard::getStepExponent() const {
+    return stepExponent;
+}
+
+double HashLifeBoard::getPopulation() const {
+    return root->population;
+}
+
+size_t HashLifeBoard::getNodeCount() const {
+    return nodeCount;
+}
+
+HashLifeBoard::Node *HashLifeBoard::allocateNode() {
+
+    if ( freeNodes == nullptr ) {
+        Node *block = new Node[NODES_PER_BLOCK];
+        for ( size_t i = 0; i < NODES_PER_BLOCK; i++ ) {
+            block[i].next = freeNodes;
+            freeNodes = &block[i];
+        }
+        blocks.push_back( block );
+    }
+
+    Node *node = freeNodes;
+    freeNodes = node->next;
+    return node;
+
+}
+
+static size_t hashChildren( const void *nw, const void *ne, const void *sw, const void *se ) {
+    uint64_t h = (uintptr_t) nw;
+    h = h * 0x9E3779B97F4A7C15ULL + (uintptr_t) ne;
+    h = h * 0x9E3779B97F4A7C15ULL + (uintptr_t) sw;
+    h = h * 0x9E3779B97F4A7C15ULL + (uintptr_t) se;
+    return h ^ ( h >> 32 );
+}
+
+/**
+ * @brief Returns the canonical node with the given children, creating it
+ * if it does not exist yet.
+ */
+HashLifeBoard::Node *HashLifeBoard::join( Node *nw, Node *ne, Node *sw, Node *se ) {
+
+    size_t index = hashChildren( nw, ne, sw, se ) & ( hashTable.size() - 1 );
+
+    for ( Node *node = hashTable[index]; node != nullptr; node = node->next ) {
+        if ( node->nw == nw && node->ne == ne && node->sw == sw && node->se == se ) {
+            return node;
+        }
+    }
+
+    Node *node = allocateNode();
+    *node = {
+        nw, ne, sw, se, nullptr, hashTable[index],
+        nw->population + ne->population + sw->population + se->population,
+        nw->level + 1, -1, false
+    };
+    hashTable[index] = node;
+    nodeCount++;
+
+    if ( nodeCount > hashTable.size() ) {
+        resizeHashTable( hashTable.size() * 2 );
+    }
+
+    return node;
+
+}
+
+HashLifeBoard::Node *HashLifeBoard::emptyNode( int level ) {
+    while ( (int) emptyNodes.size() <= level ) {
+        Node *e = emptyNodes.back();
+        emptyNodes.push_back( join( e, e, e, e ) );
+    }
+    return emptyNodes[level];
+}
+
+/**
+ * @brief Returns a node one level above with the content of node centered.
+ */
+HashLifeBoard::Node *HashLifeBoard::expand( Node *node ) {
+    Node *e = emptyNode( node->level - 1 );
+    return join( 
+        join( e, e, e, node->nw ),
+        join( e, e, node->ne, e ),
+        join( e, node->sw, e, e ),
+        join( node->se, e, e, e ) );
+}
+
+/**
+ * @brief Returns the center of node, one level below.
+ */
+HashLifeBoard::Node *HashLifeBoard::centeredSubnode( Node *node ) {
+    return join( node->nw->se, node->ne->sw, node->sw->ne, node->se->nw );
+}
+
+/**
+ * @brief Returns the node of the same level that straddles the border
+ * between w (at west) and e (at east).
+ */
+HashLifeBoard::Node *HashLifeBoard::centeredHorizontal( Node *w, Node *e ) {
+    return join( w->ne, e->nw, w->se, e->sw );
+}
+
+/**
+ * @brief Returns the node of the same level that straddles the border
+ * between n (at north) and s (at south).
+ */
+HashLifeBoard::Node *HashLifeBoard::centeredVertical( Node *n, Node *s ) {
+    return join( n->sw, n->se, s->nw, s->ne );
+}
+
+/**
+ * @brief Returns the center of node (one level below) advanced by 2^step
+ * generations, where step is at most node->level - 2.
+ */
+HashLifeBoard::Node *HashLifeBoard::successor( Node *node, int step ) {
+
+    if ( node->population == 0 ) {
+        return emptyNode( node->level - 1 );
+    }
+
+    step = std::min( step, node->level - 2 );
+
+    if ( node->result != nullptr && node->resultStep == step ) {
+        return node->result;
+    }
+
+    Node *result;
+
+    if ( node->level == 2 ) {
+
+        result = successorBaseCase( node );
+
+    } else {
+
+        // nine overlapping subnodes, one level below
+        Node *n00 = node->nw;
+        Node *n01 = centeredHorizontal( node->nw, node->ne );
+        Node *n02 = node->ne;
+        Node *n10 = centeredVertical( node->nw, node->sw );
+        Node *n11 = centeredSubnode( node );
+        Node *n12 = centeredVertical( node->ne, node->se );
+        Node *n20 = node->sw;
+        Node *n21 = centeredHorizontal( node->sw, node->se );
+        Node *n22 = node->se;
+
+        if ( step == node->level - 2 ) {
+            // full speed: both halves of the jump are done recursively
+            n00 = successor( n00, step );
+            n01 = successor( n01, step );
+            n02 = successor( n02, step );
+            n10 = successor( n10, step );
+            n11 = successor( n11, step );
+            n12 = successor( n12, step );
+            n20 = successor( n20, step );
+            n21 = successor( n21, step );
+            n22 = successor( n22, step );
+        } else {
+            // smaller jumps: the first half only shrinks the subnodes
+            n00 = centeredSubnode( n00 );
+            n01 = centeredSubnode( n01 );
+            n02 = centeredSubnode( n02 );
+            n10 = centeredSubnode( n10 );
+            n11 = centeredSubnode( n11 );
+            n12 = centeredSubnode( n12 );
+            n20 = centeredSubnode( n20 );
+            n21 = centeredSubnode( n21 );
+            n22 = centeredSubnode( n22 );
+        }
+
+        result = join( 
+            successor( join( n00, n01, n10, n11 ), step ),
+            successor( join( n01, n02, n11, n12 ), step ),
+            successor( join( n10, n11, n20, n21 ), step ),
+            successor( join( n11, n12, n21, n22 ), step ) );
+
+    }
+
+    node->result = result;
+    node->resultStep = step;
+
+    return result;
+
+}
+
+/**
+ * @brief Computes one generation of the 2x2 center of a 4x4 node.
+ */
+HashLifeBoard::Node *HashLifeBoard::successorBaseCase( Node *node ) {
+
+    // bit y*4+x holds the cell (x, y)
+    int cells = 0;
+    const Node *quadrants[4] = { node->nw, node->ne, node->sw, node->se };
+
+    for ( int q = 0; q < 4; q++ ) {
+        int x = ( q % 2 ) * 2;
+        int y = ( q / 2 ) * 2;
+        const Node *quadrant = quadrants[q];
+        cells |= ( quadrant->nw->population > 0 ) << ( y * 4 + x );
+        cells |= ( quadrant->ne->population > 0 ) << ( y * 4 + x + 1 );
+        cells |= ( quadrant->sw->population > 0 ) << ( ( y + 1 ) * 4 + x );
+        cells |= ( quadrant->se->population > 0 ) << ( ( y + 1 ) * 4 + x + 1 );
+    }
+
+    Node *next[4];
+
+    for ( int k = 0; k < 4; k++ ) {
+
+        int x = 1 + k % 2;
+        int y = 1 + k / 2;
+        int count = 0;
+
+        for ( int i = y - 1; i <= y + 1; i++ ) {
+            for ( int j = x - 1; j <= x + 1; j++ ) {
+                if ( ( i != y || j != x ) && ( ( cells >> ( i * 4 + j ) ) & 1 ) ) {
+                    count++;
+                }
+            }
+        }
+
+        bool alive = ( cells >> ( y * 4 + x ) ) & 1;
+        unsigned int mask = alive ? rule.getSurvival() : rule.getBirth();
+        next[k] = ( mask >> count ) & 1 ? liveCell : deadCell;
+
+    }
+
+    return join( next[0], next[1], next[2], next[3] );
+
+}
+
+/**
+ * @brief Returns a copy of node with the cell (x, y) changed, where x and y
+ * are relative to the top left corner of node.
+ */
+HashLifeBoard::Node *HashLifeBoard::setCell( Node *node, int64_t x, int64_t y, bool alive ) {
+
+    if ( node->level == 0 ) {
+        return alive ? liveCell : deadCell;
+    }
+
+    int64_t half = 1LL << ( node->level - 1 );
+
+    if ( y < half ) {
+        if ( x < half ) {
+            return join( setCell( node->nw, x, y, alive ), node->ne, node->sw, node->se );
+        }
+        return join( node->nw, setCell( node->ne, x - half, y, alive ), node->sw, node->se );
+    }
+
+    if ( x < half ) {
+        return join( node->nw, node->ne, setCell( node->sw, x, y - half, alive ), node->se );
+    }
+    return join( node->nw, node->ne, node->sw, setCell( node->se, x - half, y - half, alive ) );
+
+}
+
+bool HashLifeBoard::getCell( const Node *node, int64_t x, int64_t y ) const {
+
+    while ( node->level > 0 ) {
+
+        if ( node->population == 0 ) {
+            return false;
+        }
+
+        int64_t half = 1LL << ( node->level - 1 );
+
+        if ( y < half ) {
+            if ( x < half ) {
+                node = node->nw;
+            } else {
+                node = node->ne;
+                x -= half;
+            }
+        } else {
+            if ( x < half ) {
+                node = node->sw;
+            } else {
+                node = node->se;
+                x -= half;
+            }
+            y -= half;
+        }
+
+    }
+
+    return node->population > 0;
+
+}
+
+/**
+ * @brief Marks the live cells of node, whose top left corner is at (x, y)
+ * relative to the region, skipping the empty nodes and the nodes outside
+ * the region.
+ */
+void HashLifeBoard::readRegion( const Node *node, int64_t x, int64_t y, int height, int width, unsigned char *cells ) const {
+
+    int64_t size = 1LL << node->level;
+
+    if ( node->population == 0 || x >= width || y >= height || x + size <= 0 || y + size <= 0 ) {
+        return;
+    }
+
+    if ( node->level == 0 ) {
+        cells[y*width+x] = 1;
+        return;
+    }
+
+    int64_t half = size / 2;
+    readRegion( node->nw, x, y, height, width, cells );
+    readRegion( node->ne, x + half, y, height, width, cells );
+    readRegion( node->sw, x, y + half, height, width, cells );
+    readRegion( node->se, x + half, y + half, height, width, cells );
+
+}
+
+/**
+ * @brief Extends the bounds with the live cells of node, whose top left
+ * corner is at (x, y) of the universe. Nodes that lie inside the bounds
+ * found so far cannot extend them and are skipped.
+ */
+void HashLifeBoard::findLiveBounds( const Node *node, int64_t x, int64_t y, bool &found,
+                                    int64_t &minX, int64_t &minY, int64_t &maxX, int64_t &maxY ) const {
+
+    int64_t size = 1LL << node->level;
+
+    if ( node->population == 0 ||
+         ( found && x >= minX && y >= minY && x + size - 1 <= maxX && y + size - 1 <= maxY ) ) {
+        return;
+    }
+
+    if ( node->level == 0 ) {
+        if ( found ) {
+            minX = std::min( minX, x );
+            minY = std::min( minY, y );
+            maxX = std::max( maxX, x );
+            maxY = std::max( maxY, y );
+        } else {
+            minX = maxX = x;
+            minY = maxY = y;
+            found = true;
+        }
+        return;
+    }
+
+    int64_t half = size / 2;
+    findLiveBounds( node->nw, x, y, found, minX, minY, maxX, maxY );
+    findLiveBounds( node->ne, x + half, y, found, minX, minY, maxX, maxY );
+    findLiveBounds( node->sw, x, y + half, found, minX, minY, maxX, maxY );
+    findLiveBounds( node->se, x + half, y + half, found, minX, minY, maxX, maxY );
+
+}
+
+/**
+ * @brief Verifies if all the live cells of node are in its center quarter.
+ */
+bool HashLifeBoard::isPaddedForStep( const Node *node ) const {
+    return node->nw->nw->population == 0 && node->nw->ne->population == 0 && node->nw->sw->population == 0 &&
+           node->ne->nw->population == 0 && node->ne->ne->population == 0 && node->ne->se->population == 0 &&
+           node->sw->nw->population == 0 && node->sw->sw->population == 0 && node->sw->se->population == 0 &&
+           node->se->ne->population == 0 && node->se->sw->population == 0 && node->se->se->population == 0;
+}
+
+/**
+ * @brief Converts a board position to universe coordinates, where the
+ * center of the board is the origin.
+ */
+void HashLifeBoard::toUniverse( int line, int column, int64_t &x, int64_t &y ) const {
+    x = column - columns / 2;
+    y = line - lines / 2;
+}
+
+void HashLifeBoard::resizeHashTable( size_t size ) {
+
+    std::vector<Node*> newTable( size, nullptr );
+
+    for ( Node *node : hashTable ) {
+        while ( node != nullptr ) {
+            Node *next = node->next;
+            size_t index = hashChildren( node->nw, node->ne, node->sw, node->se ) & ( size - 1 );
+            node->next = newTable[index];
+            newTable[index] = node;
+            node = next;
+        }
+    }
+
+    hashTable.swap( newTable );
+
+}
+
+void HashLifeBoard::mark( Node *node, bool keepResults ) {
+
+    if ( node == nullptr || node->level == 0 || node->marked ) {
+        return;
+    }
+
+    node->marked = true;
+    mark( node->nw, keepResults );
+    mark( node->ne, keepResults );
+    mark( node->sw, keepResults );
+    mark( node->se, keepResults );
+
+    if ( keepResults ) {
+        mark( node->result, keepResults );
+    }
+
+}
+
+/**
+ * @brief Frees the nodes that are not reachable from the root. When
+ * keepResults is true, the memoized successors of the reachable nodes are
+ * kept alive too; otherwise they are forgotten.
+ */
+void HashLifeBoard::collectGarbage( bool keepResults ) {
+
+    mark( root, keepResults );
+    for ( Node *e : emptyNodes ) {
+        mark( e, keepResults );
+    }
+
+    for ( Node *&bucket : hashTable ) {
+
+        Node **link = &bucket;
+
+        while ( *link != nullptr ) {
+            Node *node = *link;
+            if ( node->marked ) {
+                node->marked = false;
+                if ( !keepResults ) {
+                    node->result = nullptr;
+                    node->resultStep = -1;
+                }
+                link = &node->next;
+            } else {
+                *link = node->next;
+                node->next = freeNodes;
+                freeNodes = node;
+                nodeCount--;
+            }
+        }
+
+    }
+
+}
@@ -0,0 +1,111 @@
+/**
+ * @file LifeBoard.cpp
+ * @author Prof. Dr. David Buzatto
+ * @brief LifeBoard class implementation.
+ * 
+ * @copyright Copyright (c) 2024
+ */
+#include <LifeBoard.h>
+
+#include <algorithm>
+#include <vector>
+#include <ThreadPool.h>
+#include <LifeRule.h>
+
+LifeBoard::LifeBoard( int lines, int columns ) :
+    lines( lines ),
+    columns( columns ),
+    generation( 0 ) {
+}
+
+LifeBoard::~LifeBoard() {
+}
+
+void LifeBoard::createNewGeneration( ThreadPool &threadPool ) {
+    createNewGeneration();
+}
+
+void LifeBoard::readRegion( int line, int column, int height, int width, unsigned char *cells ) const {
+    for ( int i = 0; i < height; i++ ) {
+        for ( int j = 0; j < width; j++ ) {
+            int l = line + i;
+            int c = column + j;
+            bool inside = l >= 0 && l < lines && c >= 0 && c < columns;
+            cells[i*width+j] = inside && getCell( l, c ) ? 1 : 0;
+        }
+    }
+}
+
+bool LifeBoard::getLiveBounds( long long &top, long long &left, long long &bottom, long long &right ) const {
+
+    std::vector<unsigned char> row( columns );
+    top = lines;
+    left = columns;
+    bottom = -1;
+    right = -1;
+
+    for ( int i = 0; i < lines; i++ ) {
+        readRegion( i, 0, 1, columns, row.data() );
+        for ( int j = 0; j < columns; j++ ) {
+            if ( row[j] ) {
+                top = std::min( top, (long long) i );
+                bottom = i;
+                left = std::min( left, (long long) j );
+                right = std::max( right, (long long) j );
+            }
+        }
+    }
+
+    return bottom >= 0;
+
+}
+
+void LifeBoard::saveCells( std::vector<unsigned char> &cells ) const {
+    cells.resize( lines * columns );
+    readRegion( 0, 0, lines, columns, cells.data() );
+}
+
+void LifeBoard::loadCells( const std::vector<unsigned char> &cells ) {
+
+    clear();
+
+    for ( int i = 0; i < lines; i++ ) {
+        for ( int j = 0; j < columns; j++ ) {
+            if ( cells[i*columns+j] ) {
+                setCell( i, j, true );
+            }
+        }
+    }
+
+    generation = 0;
+
+}
+
+bool LifeBoard::isInside( int line, int column ) const {
+    return line >= 0 && line < lines && column >= 0 && column < columns;
+}
+
+bool LifeBoard::setRule( const LifeRule &rule ) {
+    this->rule = rule;
+    return true;
+}
+
+const LifeRule &LifeBoard::getRule() const {
+    return rule;
+}
+
+int LifeBoard::getLines() const {
+    return lines;
+}
+
+int LifeBoard::getColumns() const {
+    return columns;
+}
+
+unsigned long long LifeBoard::getGeneration() const {
+    return generation;
+}
+
+void LifeBoard::setGeneration( unsigned long long generation ) {
+    this->generation = generation;
+}
@@ -0,0 +1,165 @@
+/**
+ * @file LifeRule.cpp
+ * @author Prof. Dr. David Buzatto
+ * @brief LifeRule class implementation.
+ * 
+ * @copyright Copyright (c) 2024
+ */
+#include <LifeRule.h>
+
+#include <cctype>
+#include <string>
+
+struct RulePreset {
+    unsigned int birth;
+    unsigned int survival;
+    const char *name;
+};
+
+static const RulePreset PRESETS[] = {
+    { CONWAY_BIRTH, CONWAY_SURVIVAL, "Conway" },
+    { HIGHLIFE_BIRTH, HIGHLIFE_SURVIVAL, "HighLife" },
+    { DAY_AND_NIGHT_BIRTH, DAY_AND_NIGHT_SURVIVAL, "Day & Night" },
+    { SEEDS_BIRTH, SEEDS_SURVIVAL, "Seeds" },
+    { LIFE_WITHOUT_DEATH_BIRTH, LIFE_WITHOUT_DEATH_SURVIVAL, "Life without Death" },
+    { MORLEY_BIRTH, MORLEY_SURVIVAL, "Morley" },
+    { REPLICATOR_BIRTH, REPLICATOR_SURVIVAL, "Replicator" }
+};
+
+static const int PRESET_COUNT = sizeof( PRESETS ) / sizeof( PRESETS[0] );
+
+LifeRule::LifeRule() :
+    birth( CONWAY_BIRTH ),
+    survival( CONWAY_SURVIVAL ) {
+}
+
+LifeRule::LifeRule( unsigned int birth, unsigned int survival ) :
+    birth( birth & 0x1FF ),
+    survival( survival & 0x1FF ) {
+}
+
+/**
+ * @brief Reads the digits 0 to 8 at text, advancing it, into mask.
+ */
+static bool parseCounts( const char *&text, unsigned int &mask ) {
+    mask = 0;
+    while ( std::isdigit( (unsigned char) *text ) ) {
+        if ( *text == '9' ) {
+            return false;
+        }
+        mask |= 1u << ( *text - '0' );
+        text++;
+    }
+    return true;
+}
+
+bool LifeRule::parse( const char *text, LifeRule &rule ) {
+
+    unsigned int birth = 0;
+    unsigned int survival = 0;
+
+    while ( std::isspace( (unsigned char) *text ) ) {
+        text++;
+    }
+
+    if ( std::isdigit( (unsigned char) *text ) || *text == '/' ) {
+
+        // S/B notation
+        if ( !parseCounts( text, survival ) || *text++ != '/' || !parseCounts( text, birth ) ) {
+            return false;
+        }
+
+    } else {
+
+        // B/S notation, in any order
+        bool hasBirth = false;
+        bool hasSurvival = false;
+
+        for ( int part = 0; part < 2; part++ ) {
+            char c = (char) std::toupper( (unsigned char) *text );
+            if ( c == 'B' && !hasBirth ) {
+                text++;
+                hasBirth = parseCounts( text, birth );
+            } else if ( c == 'S' && !hasSurvival ) {
+                text++;
+                hasSurvival = parseCounts( text, survival );
+            } else {
+                return false;
+            }
+            if ( part == 0 && *text++ != '/' ) {
+                return false;
+            }
+        }
+
+        if ( !hasBirth || !hasSurvival ) {
+            return false;
+        }
+
+    }
+
+    while ( std::isspace( (unsigned char) *text ) ) {
+        text++;
+    }
+
+    if ( *text != '\0' ) {
+        return false;
+    }
+
+    rule = LifeRule( birth, survival );
+    return true;
+
+}
+
+int LifeRule::getPresetCount() {
+    return PRESET_COUNT;
+}
+
+LifeRule LifeRule::getPreset( int index ) {
+    const RulePreset &preset = PRESETS[index % PRESET_COUNT];
+    return LifeRule( preset.birth, preset.survival );
+}
+
+unsigned int LifeRule::getBirth() const {
+    return birth;
+}
+
+unsigned int LifeRule::getSurvival() const {
+    return survival;
+}
+
+bool LifeRule::hasBirthOnZero() const {
+    return birth & 1;
+}
+
+std::string LifeRule::toString() const {
+
+    std::string text = "B";
+    for ( int n = 0; n <= 8; n++ ) {
+        if ( ( birth >> n ) & 1 ) {
+            text += (char) ( '0' + n );
+        }
+    }
+
+    text += "/S";
+    for ( int n = 0; n <= 8; n++ ) {
+        if ( ( survival >> n ) & 1 ) {
+            text += (char) ( '0' + n );
+        }
+    }
+
+    return text;
+
+}
+
+const char *LifeRule::getName() const {
+    for ( const RulePreset &preset : PRESETS ) {
+        if ( preset.birth == birth && preset.survival == survival ) {
+            return preset.name;
+        }
+    }
+    return "";
+}
+
+bool LifeRule::operator==( const LifeRule &other ) const {
+    return birth == other.birth && survival == other.survival;
+}
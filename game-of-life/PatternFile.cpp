@@ -0,0 +1,496 @@
+/**
+ * @file PatternFile.cpp
+ * @author Prof. Dr. David Buzatto
+ * @brief Implementation of the functions that load and save patterns.
+ * 
+ * RLE: optional "#" comment lines, an optional "x = w, y = h, ..." header
+ * and the cells as runs: "b" (or ".") for dead cells, "o" (or any other
+ * letter) for live cells, "$" for the end of a line and "!" for the end
+ * of the pattern, each one optionally preceded by a repetition count. The
+ * rule of the header, when present, replaces the rule of the board.
+ * 
+ * Life 1.06: a "#Life 1.06" line followed by one "x y" pair (column and
+ * line) per live cell.
+ * 
+ * @copyright Copyright (c) 2024
+ */
+#include <PatternFile.h>
+
+#include <algorithm>
+#include <cctype>
+#include <climits>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+#include <LifeBoard.h>
+#include <LifeRule.h>
+
+static const size_t BUFFER_SIZE = 1 << 16;
+static const int MAX_RLE_LINE_LENGTH = 70;
+
+// larger counts are not meaningful for a board indexed by int
+static const long long MAX_COUNT = INT_MAX;
+
+// the cells of each line of a saved pattern are read at once
+static const long long MAX_SAVED_WIDTH = 1 << 26;
+
+/**
+ * @brief Reads a file one character at a time through a fixed buffer.
+ */
+class PatternReader {
+
+    FILE *file;
+    std::vector<char> buffer;
+    size_t size;
+    size_t position;
+
+public:
+
+    PatternReader( FILE *file ) :
+        file( file ),
+        buffer( BUFFER_SIZE ),
+        size( 0 ),
+        position( 0 ) {
+    }
+
+    int peek() {
+        if ( position == size ) {
+            size = fread( buffer.data(), 1, buffer.size(), file );
+            position = 0;
+            if ( size == 0 ) {
+                return EOF;
+            }
+        }
+        return (unsigned char) buffer[position];
+    }
+
+    int next() {
+        int c = peek();
+        if ( c != EOF ) {
+            position++;
+        }
+        return c;
+    }
+
+    void skipLine() {
+        int c = next();
+        while ( c != EOF && c != '\n' ) {
+            c = next();
+        }
+    }
+
+    /**
+     * @brief Skips spaces and, if newLines is true, line breaks too.
+     */
+    void skipSpaces( bool newLines ) {
+        int c = peek();
+        while ( c == ' ' || c == '\t' || c == '\r' || ( newLines && c == '\n' ) ) {
+            next();
+            c = peek();
+        }
+    }
+
+    bool readInteger( long long &value ) {
+
+        skipSpaces( false );
+
+        bool negative = false;
+        if ( peek() == '-' || peek() == '+' ) {
+            negative = next() == '-';
+        }
+
+        if ( !std::isdigit( peek() ) ) {
+            return false;
+        }
+
+        value = 0;
+        while ( std::isdigit( peek() ) ) {
+            value = std::min( value * 10 + ( next() - '0' ), MAX_COUNT );
+        }
+
+        if ( negative ) {
+            value = -value;
+        }
+
+        return true;
+
+    }
+
+    /**
+     * @brief Copies at most length - 1 characters of the current line to
+     * text. Returns true if the whole line was consumed.
+     */
+    bool readLineStart( char *text, int length ) {
+        int count = 0;
+        int c = next();
+        while ( c != EOF && c != '\n' && count < length - 1 ) {
+            text[count++] = (char) c;
+            c = next();
+        }
+        text[count] = '\0';
+        return c == EOF || c == '\n';
+    }
+
+};
+
+/**
+ * @brief Writes RLE runs, breaking the lines at 70 characters.
+ */
+class RleWriter {
+
+    FILE *file;
+    int lineLength;
+
+public:
+
+    RleWriter( FILE *file ) :
+        file( file ),
+        lineLength( 0 ) {
+    }
+
+    void write( long long count, char tag ) {
+        char text[32];
+        int length = count > 1 ? 
+            snprintf( text, sizeof( text ), "%lld%c", count, tag ) : 
+            snprintf( text, sizeof( text ), "%c", tag );
+        if ( lineLength + length > MAX_RLE_LINE_LENGTH ) {
+            fputc( '\n', file );
+            lineLength = 0;
+        }
+        fputs( text, file );
+        lineLength += length;
+    }
+
+};
+
+/**
+ * @brief Places count live cells of a line, starting at column.
+ */
+static void placeRun( LifeBoard &board, long long line, long long column, long long count ) {
+
+    if ( line < INT_MIN || line > INT_MAX ) {
+        return;
+    }
+
+    long long start = std::max( column, (long long) INT_MIN );
+    long long end = std::min( column + count, (long long) INT_MAX );
+
+    for ( long long j = start; j < end; j++ ) {
+        if ( board.isInside( (int) line, (int) j ) ) {
+            board.setCell( (int) line, (int) j, true );
+        }
+    }
+
+}
+
+static bool loadRle( PatternReader &reader, LifeBoard &board ) {
+
+    long long width = 0;
+    long long height = 0;
+
+    // comments and header
+    reader.skipSpaces( true );
+    while ( reader.peek() == '#' ) {
+        reader.skipLine();
+        reader.skipSpaces( true );
+    }
+
+    if ( reader.peek() == 'x' ) {
+
+        while ( reader.peek() != '\n' && reader.peek() != EOF ) {
+
+            char key[16];
+            int keyLength = 0;
+
+            reader.skipSpaces( false );
+            while ( std::isalpha( reader.peek() ) ) {
+                int c = reader.next();
+                if ( keyLength < 15 ) {
+                    key[keyLength++] = (char) c;
+                }
+            }
+            key[keyLength] = '\0';
+
+            reader.skipSpaces( false );
+            if ( reader.next() != '=' ) {
+                std::cerr << "invalid RLE header" << std::endl;
+                return false;
+            }
+
+            if ( std::strcmp( key, "x" ) == 0 ) {
+                if ( !reader.readInteger( width ) ) {
+                    std::cerr << "invalid RLE width" << std::endl;
+                    return false;
+                }
+            } else if ( std::strcmp( key, "y" ) == 0 ) {
+                if ( !reader.readInteger( height ) ) {
+                    std::cerr << "invalid RLE height" << std::endl;
+                    return false;
+                }
+            } else if ( std::strcmp( key, "rule" ) == 0 ) {
+                char text[32];
+                int length = 0;
+                bool suffix = false;
+
+                // suffixes like ":T100,100" (the topology used by Golly)
+                // are ignored up to the end of the line, commas included
+                while ( reader.peek() != '\n' && reader.peek() != EOF &&
+                        ( suffix || reader.peek() != ',' ) ) {
+                    int c = reader.next();
+                    if ( c == ':' ) {
+                        suffix = true;
+                    } else if ( !suffix && length < 31 ) {
+                        text[length++] = (char) c;
+                    }
+                }
+                text[length] = '\0';
+
+                LifeRule rule;
+                if ( !LifeRule::parse( text, rule ) || !board.setRule( rule ) ) {
+                    std::cerr << "unsupported rule " << text << ", keeping " 
+                              << board.getRule().toString() << std::endl;
+                }
+            }
+
+            // the rest of the value is ignored
+            while ( reader.peek() != ',' && reader.peek() != '\n' && reader.peek() != EOF ) {
+                reader.next();
+            }
+            if ( reader.peek() == ',' ) {
+                reader.next();
+            }
+
+        }
+
+    }
+
+    long long top = board.getLines() / 2 - height / 2;
+    long long left = board.getColumns() / 2 - width / 2;
+    long long line = top;
+    long long column = left;
+    long long count = 0;
+
+    for ( int c = reader.next(); c != EOF && c != '!'; c = reader.next() ) {
+
+        if ( std::isdigit( c ) ) {
+            count = std::min( count * 10 + ( c - '0' ), MAX_COUNT );
+            continue;
+        }
+
+        long long run = count == 0 ? 1 : count;
+        count = 0;
+
+        if ( c == 'b' || c == '.' ) {
+            column += run;
+        } else if ( c == '$' ) {
+            line += run;
+            column = left;
+        } else if ( std::isalpha( c ) ) {
+            placeRun( board, line, column, run );
+            column += run;
+        } else if ( c == '#' ) {
+            reader.skipLine();
+        } else if ( !std::isspace( c ) ) {
+            std::cerr << "unexpected character '" << (char) c << "' in RLE pattern" << std::endl;
+            return false;
+        }
+
+    }
+
+    return true;
+
+}
+
+static bool loadLife106( PatternReader &reader, LifeBoard &board ) {
+
+    long long centerLine = board.getLines() / 2;
+    long long centerColumn = board.getColumns() / 2;
+
+    for ( reader.skipSpaces( true ); reader.peek() != EOF; reader.skipSpaces( true ) ) {
+
+        if ( reader.peek() == '#' ) {
+            reader.skipLine();
+            continue;
+        }
+
+        long long x;
+        long long y;
+        if ( !reader.readInteger( x ) || !reader.readInteger( y ) ) {
+            std::cerr << "invalid Life 1.06 coordinates" << std::endl;
+            return false;
+        }
+
+        placeRun( board, centerLine + y, centerColumn + x, 1 );
+
+    }
+
+    return true;
+
+}
+
+bool loadPattern( LifeBoard &board, const char *path ) {
+
+    FILE *file = fopen( path, "rb" );
+    if ( file == nullptr ) {
+        std::cerr << "could not open " << path << std::endl;
+        return false;
+    }
+
+    PatternReader reader( file );
+    board.clear();
+
+    bool loaded;
+    reader.skipSpaces( true );
+
+    if ( reader.peek() == '#' ) {
+
+        char header[16];
+        bool lineEnded = reader.readLineStart( header, sizeof( header ) );
+        if ( !lineEnded ) {
+            reader.skipLine();
+        }
+
+        if ( std::strncmp( header, "#Life 1.06", 10 ) == 0 ) {
+            loaded = loadLife106( reader, board );
+        } else if ( std::strncmp( header, "#Life", 5 ) == 0 ) {
+            std::cerr << "unsupported format " << header << std::endl;
+            loaded = false;
+        } else {
+            loaded = loadRle( reader, board );
+        }
+
+    } else {
+        loaded = loadRle( reader, board );
+    }
+
+    if ( ferror( file ) ) {
+        std::cerr << "could not read " << path << std::endl;
+        loaded = false;
+    }
+
+    fclose( file );
+    board.setGeneration( 0 );
+
+    return loaded;
+
+}
+
+static bool endsWith( const char *text, const char *suffix ) {
+
+    size_t textLength = std::strlen( text );
+    size_t suffixLength = std::strlen( suffix );
+
+    if ( textLength < suffixLength ) {
+        return false;
+    }
+
+    for ( size_t i = 0; i < suffixLength; i++ ) {
+        if ( std::tolower( (unsigned char) text[textLength-suffixLength+i] ) != suffix[i] ) {
+            return false;
+        }
+    }
+
+    return true;
+
+}
+
+bool savePattern( const LifeBoard &board, const char *path ) {
+
+    int lines = board.getLines();
+    int columns = board.getColumns();
+
+    // bounding box of the live cells, that can be beyond the window of
+    // an unbounded board
+    long long minLine;
+    long long minColumn;
+    long long maxLine;
+    long long maxColumn;
+
+    if ( !board.getLiveBounds( minLine, minColumn, maxLine, maxColumn ) ) {
+        minLine = 0;
+        minColumn = 0;
+        maxLine = -1;
+        maxColumn = -1;
+    } else if ( minLine < INT_MIN || minColumn < INT_MIN || maxLine > INT_MAX || maxColumn > INT_MAX ||
+                maxColumn - minColumn + 1 > MAX_SAVED_WIDTH ) {
+        std::cerr << "the pattern is too large to be saved" << std::endl;
+        return false;
+    }
+
+    std::vector<unsigned char> row( maxColumn - minColumn + 1 );
+
+    FILE *file = fopen( path, "wb" );
+    if ( file == nullptr ) {
+        std::cerr << "could not create " << path << std::endl;
+        return false;
+    }
+
+    if ( endsWith( path, ".lif" ) || endsWith( path, ".life" ) ) {
+
+        fputs( "#Life 1.06\n", file );
+
+        for ( long long i = minLine; i <= maxLine; i++ ) {
+            board.readRegion( (int) i, (int) minColumn, 1, (int) row.size(), row.data() );
+            for ( size_t j = 0; j < row.size(); j++ ) {
+                if ( row[j] ) {
+                    fprintf( file, "%lld %lld\n", minColumn + (long long) j - columns / 2, i - lines / 2 );
+                }
+            }
+        }
+
+    } else {
+
+        fprintf( file, "x = %lld, y = %lld, rule = %s\n", maxColumn - minColumn + 1, maxLine - minLine + 1, 
+                 board.getRule().toString().c_str() );
+
+        RleWriter writer( file );
+        long long pendingLines = 0;
+
+        for ( long long i = minLine; i <= maxLine; i++ ) {
+
+            board.readRegion( (int) i, (int) minColumn, 1, (int) row.size(), row.data() );
+            long long deadRun = 0;
+
+            // dead cells at the end of a line and empty lines at the end
+            // of the pattern are not written
+            for ( size_t j = 0; j < row.size(); ) {
+                size_t k = j;
+                while ( k < row.size() && row[k] == row[j] ) {
+                    k++;
+                }
+                if ( row[j] ) {
+                    if ( pendingLines > 0 ) {
+                        writer.write( pendingLines, '$' );
+                        pendingLines = 0;
+                    }
+                    if ( deadRun > 0 ) {
+                        writer.write( deadRun, 'b' );
+                        deadRun = 0;
+                    }
+                    writer.write( k - j, 'o' );
+                } else {
+                    deadRun += k - j;
+                }
+                j = k;
+            }
+
+            pendingLines++;
+
+        }
+
+        writer.write( 1, '!' );
+        fputc( '\n', file );
+
+    }
+
+    bool saved = !ferror( file );
+    if ( fclose( file ) != 0 || !saved ) {
+        std::cerr << "could not write " << path << std::endl;
+        return false;
+    }
+
+    return true;
+
+}
@@ -0,0 +1,65 @@
+/**
+ * @file Patterns.cpp
+ * @author Prof. Dr. David Buzatto
+ * @brief Functions that place initial patterns on a board.
+ * 
+ * @copyright Copyright (c) 2024
+ */
+#include <Patterns.h>
+
+#include <random>
+#include <LifeBoard.h>
+
+// line and column offsets from the center of the board
+static const int DEFAULT_PATTERN[][2] = {
+    { -7, -6 },
+    { -6, -7 },
+    { -5, -7 },
+    { -5, -6 },
+    { -5, -5 },
+    { -6, 5 },
+    { -7, 4 },
+    { -7, 3 },
+    { -6, 3 },
+    { -5, 3 },
+    { 5, 4 },
+    { 4, 5 },
+    { 3, 5 },
+    { 3, 4 },
+    { 3, 3 },
+    { 4, -7 },
+    { 5, -6 },
+    { 5, -5 },
+    { 4, -5 },
+    { 3, -5 }
+};
+
+void placeDefaultPattern( LifeBoard &board ) {
+
+    int centerLine = board.getLines() / 2;
+    int centerColumn = board.getColumns() / 2;
+
+    for ( const int *cell : DEFAULT_PATTERN ) {
+        int line = centerLine + cell[0];
+        int column = centerColumn + cell[1];
+        if ( line >= 0 && line < board.getLines() && column >= 0 && column < board.getColumns() ) {
+            board.setCell( line, column, true );
+        }
+    }
+
+}
+
+void placeRandomSoup( LifeBoard &board, double density, unsigned int seed ) {
+
+    std::mt19937 random( seed );
+    std::bernoulli_distribution alive( density );
+
+    for ( int i = 0; i < board.getLines(); i++ ) {
+        for ( int j = 0; j < board.getColumns(); j++ ) {
+            if ( alive( random ) ) {
+                board.setCell( i, j, true );
+            }
+        }
+    }
+
+}
@@ -0,0 +1,540 @@
+/**
+ * @file Simulation.cpp
+ * @author Prof. Dr. David Buzatto
+ * @brief Simulation class implementation.
+ * 
+ * @copyright Copyright (c) 2024
+ */
+#include <Simulation.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <BoardType.h>
+#include <LifeBoard.h>
+#include <LifeRule.h>
+#include <GridBoard.h>
+#include <ArrayBoard.h>
+#include <BitBoard.h>
+#include <HashLifeBoard.h>
+#include <ThreadPool.h>
+#include <Patterns.h>
+#include <PatternFile.h>
+
+// how long the thread sleeps when there is nothing to do
+static const std::chrono::microseconds IDLE_SLEEP( 1000 );
+
+// how often the generations per second are measured
+static const std::chrono::milliseconds RATE_WINDOW( 500 );
+
+// the fastest a cycle is replayed (about one generation per frame), since
+// replaying faster would only burn processor time
+static const std::chrono::microseconds MIN_REPLAY_INTERVAL( 16667 );
+
+Simulation::Simulation( int lines, int columns, BoardType boardType, int threadCount ) :
+    lines( lines ),
+    columns( columns ),
+    boardType( boardType ),
+    threadPool( threadCount ),
+    running( false ),
+    interval( 0 ),
+    tileTracking( true ),
+    torus( false ),
+    parallelStepping( true ),
+    stepExponent( 0 ),
+    generationsPerSecond( 0 ),
+    cycleMode( CYCLE_REPLAY ),
+    cycleDetector( MAX_CYCLE_PERIOD ),
+    confirmingPeriod( 0 ),
+    cyclePeriod( 0 ),
+    cycleStart( 0 ),
+    cycleStops( 0 ),
+    replaying( false ),
+    replayFrame( 0 ),
+    replayGeneration( 0 ),
+    stopping( false ) {
+
+    board = createBoard( boardType );
+    applySettings();
+    placeDefaultPattern( *board );
+
+    // the first snapshot is published before the thread starts, so the
+    // interface always has something to draw
+    fillSnapshot( snapshots.getBack() );
+    snapshots.publish();
+
+    thread = std::thread( &Simulation::run, this );
+
+}
+
+Simulation::~Simulation() {
+    stopping.store( true, std::memory_order_release );
+    thread.join();
+    delete board;
+}
+
+bool Simulation::send( const SimulationCommand &command ) {
+    return commands.push( command );
+}
+
+bool Simulation::setCell( int line, int column, bool alive ) {
+    return send( { SET_CELL, line, column, alive ? 1 : 0, "" } );
+}
+
+bool Simulation::setRunning( bool running ) {
+    return send( { SET_RUNNING, 0, 0, running ? 1 : 0, "" } );
+}
+
+bool Simulation::setInterval( double seconds ) {
+    return send( { SET_INTERVAL, 0, 0, (int) ( seconds * 1000000 ), "" } );
+}
+
+bool Simulation::saveResetCells() {
+    return send( { SAVE_RESET_CELLS, 0, 0, 0, "" } );
+}
+
+bool Simulation::reset() {
+    return send( { RESET, 0, 0, 0, "" } );
+}
+
+bool Simulation::setBoardType( BoardType boardType ) {
+    return send( { SET_BOARD_TYPE, 0, 0, (int) boardType, "" } );
+}
+
+bool Simulation::setTileTracking( bool tileTracking ) {
+    return send( { SET_TILE_TRACKING, 0, 0, tileTracking ? 1 : 0, "" } );
+}
+
+bool Simulation::setTorus( bool torus ) {
+    return send( { SET_TORUS, 0, 0, torus ? 1 : 0, "" } );
+}
+
+bool Simulation::setParallelStepping( bool parallelStepping ) {
+    return send( { SET_PARALLEL_STEPPING, 0, 0, parallelStepping ? 1 : 0, "" } );
+}
+
+bool Simulation::changeStepExponent( int delta ) {
+    return send( { CHANGE_STEP_EXPONENT, 0, 0, delta, "" } );
+}
+
+bool Simulation::setRule( const LifeRule &rule ) {
+    return send( { SET_RULE, 0, 0, (int) ( rule.getBirth() | rule.getSurvival() << 9 ), "" } );
+}
+
+bool Simulation::setCycleMode( CycleMode cycleMode ) {
+    return send( { SET_CYCLE_MODE, 0, 0, (int) cycleMode, "" } );
+}
+
+bool Simulation::loadPattern( const std::string &path ) {
+    return send( { LOAD_PATTERN, 0, 0, 0, path } );
+}
+
+bool Simulation::savePattern( const std::string &path ) {
+    return send( { SAVE_PATTERN, 0, 0, 0, path } );
+}
+
+bool Simulation::acquireSnapshot() {
+    return snapshots.acquire();
+}
+
+const BoardSnapshot &Simulation::getSnapshot() const {
+    return snapshots.getFront();
+}
+
+int Simulation::getLines() const {
+    return lines;
+}
+
+int Simulation::getColumns() const {
+    return columns;
+}
+
+int Simulation::getThreadCount() const {
+    return threadPool.getThreadCount();
+}
+
+/**
+ * @brief The simulation loop. Executes the queued commands, creates a
+ * new generation when it is time to and publishes a snapshot when the
+ * cells changed and the interface already took the previous one, so at
+ * most one snapshot is copied per frame no matter how fast the
+ * generations are.
+ */
+void Simulation::run() {
+
+    using Clock = std::chrono::steady_clock;
+
+    Clock::time_point lastGeneration = Clock::now();
+    Clock::time_point rateStart = lastGeneration;
+    unsigned long long rateGeneration = getCurrentGeneration();
+    bool changed = false;
+
+    while ( !stopping.load( std::memory_order_acquire ) ) {
+
+        if ( executeCommands() ) {
+            changed = true;
+            rateGeneration = getCurrentGeneration();
+        }
+
+        Clock::time_point now = Clock::now();
+        bool waiting = true;
+
+        if ( running && now - lastGeneration >= getStepInterval() ) {
+            if ( replaying ) {
+                replayFrame = ( replayFrame + 1 ) % (int) cycleFrames.size();
+                replayGeneration++;
+            } else if ( !detectCycle() ) {
+                createNewGeneration();
+            }
+            lastGeneration = now;
+            changed = true;
+            waiting = false;
+        }
+
+        if ( now - rateStart >= RATE_WINDOW ) {
+            double seconds = std::chrono::duration<double>( now - rateStart ).count();
+            double rate = running ? ( getCurrentGeneration() - rateGeneration ) / seconds : 0;
+            if ( rate != generationsPerSecond ) {
+                generationsPerSecond = rate;
+                changed = true;
+            }
+            rateStart = now;
+            rateGeneration = getCurrentGeneration();
+        }
+
+        if ( changed && snapshots.isConsumed() ) {
+            fillSnapshot( snapshots.getBack() );
+            snapshots.publish();
+            changed = false;
+        }
+
+        if ( waiting ) {
+            std::chrono::microseconds sleep = IDLE_SLEEP;
+            if ( running ) {
+                sleep = std::min( sleep, std::chrono::duration_cast<std::chrono::microseconds>( 
+                                             getStepInterval() - ( now - lastGeneration ) ) );
+            }
+            std::this_thread::sleep_for( sleep );
+        }
+
+    }
+
+}
+
+/**
+ * @brief Executes all queued commands. Returns true if any of them was
+ * executed.
+ */
+bool Simulation::executeCommands() {
+
+    SimulationCommand command;
+    bool executed = false;
+
+    while ( commands.pop( command ) ) {
+        execute( command );
+        executed = true;
+    }
+
+    return executed;
+
+}
+
+void Simulation::execute( const SimulationCommand &command ) {
+
+    SimulationCommandType type = command.type;
+
+    // the board must hold the generation that is shown before it is used
+    // and the cycle is forgotten when the cells may change
+    if ( type != SET_RUNNING && type != SET_INTERVAL && type != SET_PARALLEL_STEPPING && 
+         type != SET_TILE_TRACKING && type != CHANGE_STEP_EXPONENT && 
+         ( type != SET_CYCLE_MODE || command.value != CYCLE_REPLAY ) ) {
+        leaveReplay();
+    }
+
+    if ( type == SET_CELL || type == RESET || type == SET_BOARD_TYPE || type == SET_RULE || 
+         type == SET_TORUS || type == LOAD_PATTERN ) {
+        resetCycleDetection();
+        cyclePeriod = 0;
+    }
+
+    switch ( type ) {
+
+        case SET_CELL:
+            if ( command.line >= 0 && command.line < lines && 
+                 command.column >= 0 && command.column < columns ) {
+                board->setCell( command.line, command.column, command.value != 0 );
+            }
+            break;
+
+        case SET_RUNNING:
+            running = command.value != 0;
+            break;
+
+        case SET_INTERVAL:
+            interval = std::chrono::microseconds( std::max( 0, command.value ) );
+            break;
+
+        case SAVE_RESET_CELLS:
+            board->saveCells( resetCells );
+            break;
+
+        case RESET:
+            board->loadCells( resetCells );
+            break;
+
+        case SET_BOARD_TYPE: {
+            std::vector<unsigned char> cells;
+            board->saveCells( cells );
+            delete board;
+            boardType = (BoardType) command.value;
+            board = createBoard( boardType );
+            board->setRule( rule );
+            rule = board->getRule();
+            board->loadCells( cells );
+            break;
+        }
+
+        case SET_TILE_TRACKING:
+            tileTracking = command.value != 0;
+            break;
+
+        case SET_TORUS:
+            torus = command.value != 0;
+            break;
+
+        case SET_PARALLEL_STEPPING:
+            parallelStepping = command.value != 0;
+            break;
+
+        case CHANGE_STEP_EXPONENT:
+            stepExponent = std::max( 0, stepExponent + command.value );
+            break;
+
+        case SET_RULE:
+            if ( board->setRule( LifeRule( command.value & 0x1FF, command.value >> 9 ) ) ) {
+                rule = board->getRule();
+            }
+            break;
+
+        case SET_CYCLE_MODE:
+            cycleMode = (CycleMode) command.value;
+            break;
+
+        case LOAD_PATTERN:
+            running = false;
+            if ( ::loadPattern( *board, command.path.c_str() ) ) {
+                std::cout << "pattern loaded from " << command.path << std::endl;
+            }
+            rule = board->getRule();
+            break;
+
+        case SAVE_PATTERN:
+            if ( ::savePattern( *board, command.path.c_str() ) ) {
+                std::cout << "pattern saved to " << command.path << std::endl;
+            }
+            break;
+
+    }
+
+    applySettings();
+
+}
+
+/**
+ * @brief Applies the settings to the current board.
+ */
+void Simulation::applySettings() {
+
+    GridBoard *gridBoard = dynamic_cast<GridBoard*>( board );
+    if ( gridBoard != nullptr ) {
+        gridBoard->setTileTracking( tileTracking );
+        gridBoard->setTorus( torus );
+    }
+
+    if ( boardType == BoardType::HASHLIFE_BOARD ) {
+        HashLifeBoard *hashLife = static_cast<HashLifeBoard*>( board );
+        hashLife->setStepExponent( stepExponent );
+        stepExponent = hashLife->getStepExponent();
+    }
+
+}
+
+void Simulation::createNewGeneration() {
+    if ( parallelStepping ) {
+        board->createNewGeneration( threadPool );
+    } else {
+        board->createNewGeneration();
+    }
+}
+
+/**
+ * @brief Looks for a cycle before the current generation of a grid board
+ * is advanced. A repeated hash is only a candidate: the cycle is
+ * confirmed when the hash of every generation of the following period
+ * repeats too, while the generations are stored for the replay. Only the
+ * 64-bit hashes are compared, so this makes a false cycle caused by a
+ * hash collision much less likely, but not impossible. Returns true if
+ * the cycle was confirmed (and the simulation paused or started to
+ * replay it).
+ */
+bool Simulation::detectCycle() {
+
+    GridBoard *gridBoard = dynamic_cast<GridBoard*>( board );
+    if ( gridBoard == nullptr || cycleMode == CYCLE_IGNORE ) {
+        return false;
+    }
+
+    int period = cycleDetector.add( gridBoard->getHash() );
+
+    if ( confirmingPeriod > 0 && period != confirmingPeriod ) {
+        confirmingPeriod = 0;
+        cycleFrames.clear();
+    }
+
+    if ( confirmingPeriod == 0 ) {
+        if ( period > 0 ) {
+            confirmingPeriod = period;
+            captureCycleFrame();
+        }
+        return false;
+    }
+
+    if ( (int) cycleFrames.size() < confirmingPeriod ) {
+        captureCycleFrame();
+        return false;
+    }
+
+    // the current generation repeats the first stored one, which happened
+    // two periods ago; the cycle started one period before it
+    cyclePeriod = confirmingPeriod;
+    cycleStart = board->getGeneration() - 2 * cyclePeriod;
+    confirmingPeriod = 0;
+    cycleStops++;
+
+    std::cout << "cycle of period " << cyclePeriod << " since generation " << cycleStart << std::endl;
+
+    if ( cycleMode == CYCLE_PAUSE ) {
+        running = false;
+        resetCycleDetection();
+    } else {
+        replaying = true;
+        replayFrame = 0;
+        replayGeneration = board->getGeneration();
+    }
+
+    return true;
+
+}
+
+void Simulation::captureCycleFrame() {
+
+    frameCells.resize( lines * columns );
+    board->readRegion( 0, 0, lines, columns, frameCells.data() );
+
+    std::vector<uint64_t> frame( ( frameCells.size() + 63 ) / 64, 0 );
+    for ( size_t i = 0; i < frameCells.size(); i++ ) {
+        frame[i/64] |= (uint64_t) frameCells[i] << ( i % 64 );
+    }
+
+    cycleFrames.push_back( std::move( frame ) );
+
+}
+
+/**
+ * @brief Stops replaying the cycle, putting the generation being shown
+ * back in the board.
+ */
+void Simulation::leaveReplay() {
+
+    if ( !replaying ) {
+        return;
+    }
+
+    const std::vector<uint64_t> &frame = cycleFrames[replayFrame];
+    frameCells.resize( lines * columns );
+    for ( size_t i = 0; i < frameCells.size(); i++ ) {
+        frameCells[i] = ( frame[i/64] >> ( i % 64 ) ) & 1;
+    }
+
+    board->loadCells( frameCells );
+    board->setGeneration( replayGeneration );
+    replaying = false;
+    resetCycleDetection();
+
+}
+
+void Simulation::resetCycleDetection() {
+    cycleDetector.clear();
+    confirmingPeriod = 0;
+    cycleFrames.clear();
+}
+
+unsigned long long Simulation::getCurrentGeneration() const {
+    return replaying ? replayGeneration : board->getGeneration();
+}
+
+std::chrono::microseconds Simulation::getStepInterval() const {
+    return replaying ? std::max( interval, MIN_REPLAY_INTERVAL ) : interval;
+}
+
+void Simulation::fillSnapshot( BoardSnapshot &snapshot ) const {
+
+    snapshot.cells.resize( lines * columns );
+
+    if ( replaying ) {
+        const std::vector<uint64_t> &frame = cycleFrames[replayFrame];
+        for ( size_t i = 0; i < snapshot.cells.size(); i++ ) {
+            snapshot.cells[i] = ( frame[i/64] >> ( i % 64 ) ) & 1;
+        }
+    } else {
+        board->readRegion( 0, 0, lines, columns, snapshot.cells.data() );
+    }
+
+    snapshot.generation = getCurrentGeneration();
+    snapshot.cyclePeriod = cyclePeriod;
+    snapshot.cycleStart = cycleStart;
+    snapshot.replaying = replaying;
+    snapshot.cycleStops = cycleStops;
+    snapshot.boardName = board->getName();
+    snapshot.rule = board->getRule();
+    snapshot.generationsPerSecond = generationsPerSecond;
+
+    const GridBoard *gridBoard = dynamic_cast<const GridBoard*>( board );
+    snapshot.gridBoard = gridBoard != nullptr;
+    if ( gridBoard != nullptr ) {
+        snapshot.activeTileCount = gridBoard->getActiveTileCount();
+        snapshot.tileCount = gridBoard->getTileCount();
+    }
+
+    snapshot.hashLife = boardType == BoardType::HASHLIFE_BOARD;
+    if ( snapshot.hashLife ) {
+        const HashLifeBoard *hashLife = static_cast<const HashLifeBoard*>( board );
+        snapshot.stepExponent = hashLife->getStepExponent();
+        snapshot.population = hashLife->getPopulation();
+        snapshot.nodeCount = hashLife->getNodeCount();
+    }
+
+}
+
+/**
+ * @brief Creates an empty board of the given type with the simulation
+ * dimensions.
+ */
+LifeBoard *Simulation::createBoard( BoardType boardType ) const {
+    switch ( boardType ) {
+        case BoardType::ARRAY_BOARD:
+            return new ArrayBoard( lines, columns );
+        case BoardType::HASHLIFE_BOARD:
+            return new HashLifeBoard( lines, columns );
+        case BoardType::BIT_BOARD:
+        default:
+            return new BitBoard( lines, columns );
+    }
+}
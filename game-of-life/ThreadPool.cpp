@@ -0,0 +1,106 @@
+/**
+ * @file ThreadPool.cpp
+ * @author Prof. Dr. David Buzatto
+ * @brief ThreadPool class implementation.
+ * 
+ * @copyright Copyright (c) 2024
+ */
+#include <ThreadPool.h>
+
+#include <functional>
+#include <mutex>
+#include <thread>
+
+ThreadPool::ThreadPool( int threadCount ) :
+    taskCount( 0 ),
+    nextTask( 0 ),
+    pendingTasks( 0 ),
+    batch( 0 ),
+    stopping( false ) {
+
+    for ( int i = 1; i < threadCount; i++ ) {
+        workers.emplace_back( &ThreadPool::workerLoop, this );
+    }
+
+}
+
+ThreadPool::~ThreadPool() {
+
+    {
+        std::lock_guard<std::mutex> lock( mutex );
+        stopping = true;
+    }
+    batchStarted.notify_all();
+
+    for ( std::thread &worker : workers ) {
+        worker.join();
+    }
+
+}
+
+void ThreadPool::run( int taskCount, const std::function<void( int )> &task ) {
+
+    std::unique_lock<std::mutex> lock( mutex );
+
+    this->task = task;
+    this->taskCount = taskCount;
+    nextTask = 0;
+    pendingTasks = taskCount;
+    batch++;
+    batchStarted.notify_all();
+
+    while ( executeNextTask( lock ) ) {
+    }
+
+    batchFinished.wait( lock, [this]{ return pendingTasks == 0; } );
+    this->task = nullptr;
+
+}
+
+int ThreadPool::getThreadCount() const {
+    return workers.size() + 1;
+}
+
+void ThreadPool::workerLoop() {
+
+    std::unique_lock<std::mutex> lock( mutex );
+    unsigned long long lastBatch = batch;
+
+    while ( true ) {
+
+        batchStarted.wait( lock, [this, lastBatch]{ return stopping || batch != lastBatch; } );
+        if ( stopping ) {
+            return;
+        }
+        lastBatch = batch;
+
+        while ( executeNextTask( lock ) ) {
+        }
+
+    }
+
+}
+
+/**
+ * @brief Takes the next task of the current batch and executes it with the
+ * mutex released. Returns false when there are no more tasks to take.
+ */
+bool ThreadPool::executeNextTask( std::unique_lock<std::mutex> &lock ) {
+
+    if ( nextTask >= taskCount ) {
+        return false;
+    }
+
+    int current = nextTask++;
+
+    lock.unlock();
+    task( current );
+    lock.lock();
+
+    if ( --pendingTasks == 0 ) {
+        batchFinished.notify_all();
+    }
+
+    return true;
+
+}
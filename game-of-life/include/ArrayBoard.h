@@ -0,0 +1,69 @@
+/**
+ * @file ArrayBoard.h
+ * @author Prof. Dr. David Buzatto
+ * @brief ArrayBoard class declaration. Stores one int per cell and counts
+ * the neighbors of each cell one by one. The cells are surrounded by a
+ * one-cell halo, so counting the neighbors does not need bounds checks.
+ * 
+ * @copyright Copyright (c) 2024
+ */
+#pragma once
+
+#include <cstdint>
+#include <GridBoard.h>
+
+class ArrayBoard : public GridBoard {
+
+    typedef bool ( ArrayBoard::*TileKernel )( int tileLine, int tileColumn );
+
+    int *evolutionArray;
+    int *newGeneration;
+    int evolutionArraySize;
+    int paddedColumns;
+
+    TileKernel tileKernel;
+
+    // next state of a dead ( [0] ) and of a live ( [1] ) cell for each
+    // number of live neighbors, used by the rules without a specialized
+    // kernel
+    int nextState[2][9];
+
+public:
+
+    /**
+     * @brief Construct a new ArrayBoard object.
+     */
+    ArrayBoard( int lines, int columns );
+
+    /**
+     * @brief Destroy the ArrayBoard object.
+     */
+    ~ArrayBoard();
+
+    virtual bool getCell( int line, int column ) const;
+    virtual void setCell( int line, int column, bool alive );
+    virtual void clear();
+    virtual const char *getName() const;
+    virtual void readRegion( int line, int column, int height, int width, unsigned char *cells ) const;
+
+protected:
+
+    virtual void refreshHalo();
+    virtual void selectTileKernel();
+    virtual bool createNewTile( int tileLine, int tileColumn );
+    virtual void swapGenerations();
+    virtual uint64_t hashTile( int tileLine, int tileColumn ) const;
+
+private:
+
+    template<unsigned int BIRTH, unsigned int SURVIVAL>
+    bool createNewTileWithRule( int tileLine, int tileColumn );
+    bool createNewTileWithTable( int tileLine, int tileColumn );
+
+    template<typename NextState>
+    bool createNewTileCells( int tileLine, int tileColumn, NextState nextState );
+
+    int countNeighbors( int p ) const;
+    int index( int line, int column ) const;
+
+};
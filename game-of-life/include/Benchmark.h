@@ -0,0 +1,31 @@
+/**
+ * @file Benchmark.h
+ * @author Prof. Dr. David Buzatto
+ * @brief Headless benchmark of the board backends. It does not open a
+ * window, so it can run on machines without a GPU, and prints one CSV
+ * line per backend.
+ * 
+ * @copyright Copyright (c) 2024
+ */
+#pragma once
+
+/**
+ * @brief Verifies if the command line asks for the benchmark mode.
+ */
+bool isBenchmarkMode( int argc, char **argv );
+
+/**
+ * @brief Runs the benchmark described by the command line and returns the
+ * exit code of the program.
+ * 
+ * Usage: --benchmark [--board all|array|bit|hashlife] [--lines n]
+ * [--columns n] [--generations n] [--threads n] [--tiles on|off] [--torus on|off]
+ * [--step k] [--pattern default|random|file] [--rule B3/S23]
+ * [--density d] [--seed s] [--header on|off]
+ * 
+ * The peak_memory_kb column is the peak resident memory of the process
+ * that ran the backend. With --board all, each backend runs in a process
+ * of its own (this program started again with --board), so the column is
+ * the peak of that backend alone.
+ */
+int runBenchmark( int argc, char **argv );
@@ -0,0 +1,67 @@
+/**
+ * @file BoardRenderer.h
+ * @author Prof. Dr. David Buzatto
+ * @brief BoardRenderer class declaration. Draws the visible window of a
+ * board as one texture (one texel per cell) that is updated only when the
+ * cells change and scaled to the screen with a single draw call. The grid
+ * lines of each zoom level are drawn once into a cached render texture.
+ * 
+ * The textures are created on demand, since the window (and the OpenGL
+ * context) does not exist yet when the game world is created.
+ * 
+ * @copyright Copyright (c) 2024
+ */
+#pragma once
+
+#include <vector>
+#include <raylib.h>
+
+class BoardRenderer {
+
+    int size;
+    Texture2D cellsTexture;
+    std::vector<RenderTexture2D> gridTextures;
+    std::vector<int> gridCellWidths;
+    std::vector<Color> pixels;
+    int visibleCells;
+
+public:
+
+    /**
+     * @brief Construct a new BoardRenderer object that draws in a square
+     * of size x size pixels.
+     */
+    BoardRenderer( int size );
+
+    /**
+     * @brief Destroy the BoardRenderer object.
+     */
+    ~BoardRenderer();
+
+    /**
+     * @brief Copies the visibleCells x visibleCells cells that start at
+     * (startLine, startColumn) of a board stored line by line, with
+     * columns cells per line, to the cells texture.
+     */
+    void update( const std::vector<unsigned char> &boardCells, int columns, 
+                 int startLine, int startColumn, int visibleCells );
+
+    /**
+     * @brief Draws the grid lines of one zoom level into a render texture,
+     * if it was not drawn yet.
+     */
+    void prepareGrid( int zoom, int cellWidth );
+
+    /**
+     * @brief Draws the cells texture scaled by cellWidth and, optionally,
+     * the grid of the zoom level (prepared with prepareGrid).
+     */
+    void draw( int zoom, int cellWidth, bool drawGrid ) const;
+
+    /**
+     * @brief Unloads the textures. Must be called while the window is
+     * still open.
+     */
+    void unloadTextures();
+
+};
@@ -0,0 +1,15 @@
+/**
+ * @file BoardType.h
+ * @author Prof. Dr. David Buzatto
+ * @brief BoardType enum declaration. The board backends that the
+ * simulation can switch between.
+ * 
+ * @copyright Copyright (c) 2024
+ */
+#pragma once
+
+enum BoardType {
+    ARRAY_BOARD,
+    BIT_BOARD,
+    HASHLIFE_BOARD
+};
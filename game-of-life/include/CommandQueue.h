@@ -0,0 +1,64 @@
+/**
+ * @file CommandQueue.h
+ * @author Prof. Dr. David Buzatto
+ * @brief CommandQueue class declaration and implementation. A bounded
+ * lock-free ring buffer for exactly one producer thread and one consumer
+ * thread.
+ * 
+ * @copyright Copyright (c) 2024
+ */
+#pragma once
+
+#include <atomic>
+
+template<typename T, unsigned int CAPACITY>
+class CommandQueue {
+
+    static_assert( ( CAPACITY & ( CAPACITY - 1 ) ) == 0, "the capacity must be a power of two" );
+
+    T items[CAPACITY];
+
+    // the indexes only grow (wrapping around) and are kept in different
+    // cache lines, since each one is written by a different thread
+    alignas( 64 ) std::atomic<unsigned int> head;
+    alignas( 64 ) std::atomic<unsigned int> tail;
+
+public:
+
+    /**
+     * @brief Construct a new, empty, CommandQueue object.
+     */
+    CommandQueue() :
+        head( 0 ),
+        tail( 0 ) {
+    }
+
+    /**
+     * @brief Enqueues an item. Called by the producer. Returns false,
+     * without waiting, if the queue is full.
+     */
+    bool push( const T &item ) {
+        unsigned int t = tail.load( std::memory_order_relaxed );
+        if ( t - head.load( std::memory_order_acquire ) == CAPACITY ) {
+            return false;
+        }
+        items[t & ( CAPACITY - 1 )] = item;
+        tail.store( t + 1, std::memory_order_release );
+        return true;
+    }
+
+    /**
+     * @brief Dequeues an item. Called by the consumer. Returns false if
+     * the queue is empty.
+     */
+    bool pop( T &item ) {
+        unsigned int h = head.load( std::memory_order_relaxed );
+        if ( h == tail.load( std::memory_order_acquire ) ) {
+            return false;
+        }
+        item = items[h & ( CAPACITY - 1 )];
+        head.store( h + 1, std::memory_order_release );
+        return true;
+    }
+
+};
@@ -0,0 +1,44 @@
+/**
+ * @file CycleDetector.h
+ * @author Prof. Dr. David Buzatto
+ * @brief CycleDetector class declaration. Keeps the hashes of the last
+ * generations in a ring and finds when a generation repeats one of them,
+ * which means the board became periodic (still lifes have period 1).
+ * 
+ * @copyright Copyright (c) 2024
+ */
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+class CycleDetector {
+
+    std::vector<uint64_t> hashes;
+    int count;
+    int next;
+
+public:
+
+    /**
+     * @brief Construct a new CycleDetector object that detects periods up
+     * to maxPeriod.
+     */
+    CycleDetector( int maxPeriod );
+
+    /**
+     * @brief Forgets every generation.
+     */
+    void clear();
+    bool isEmpty() const;
+
+    /**
+     * @brief Adds the hash of the generation that follows the last one
+     * added and returns the smallest period p such that the generation
+     * added p generations ago has the same hash, or zero if there is none.
+     */
+    int add( uint64_t hash );
+
+    int getMaxPeriod() const;
+
+};
@@ -39,5 +39,10 @@ public:
      * finishes, the window will be finished too.
      */
     void init();
+
+    /**
+     * @brief Loads the initial pattern from a RLE or Life 1.06 file.
+     */
+    void loadPattern( const std::string &path );
     
 };
\ No newline at end of file
@@ -8,9 +8,15 @@
  */
 #pragma once
 
+#include <string>
+#include <vector>
+
 #include <raylib.h>
 #include <Drawable.h>
 #include <GameState.h>
+#include <BoardType.h>
+#include <Simulation.h>
+#include <BoardRenderer.h>
 
 class GameWorld : public virtual Drawable {
 
@@ -19,10 +25,14 @@ class GameWorld : public virtual Drawable {
     int lines;
     int columns;
 
-    int *evolutionArray;
-    int *resetArray;
-    int *newGeneration;
-    int evolutionArraySize;
+    Simulation *simulation;
+    BoardType boardType;
+    int ruleIndex;
+    CycleMode cycleMode;
+    unsigned int cycleStops;
+    bool tileTracking;
+    bool torus;
+    bool parallelStepping;
 
     const int MAX_ZOOM = 6;
     const int allowedCellWidths[8] = { 1, 2, 4, 8, 12, 24, 48 };
@@ -35,8 +45,9 @@ class GameWorld : public virtual Drawable {
     int endColumn;
 
     bool drawGrid;
+    BoardRenderer renderer;
+    bool cellsChanged;
 
-    float currentTime;
     float timeToWait;
     GameState state;
 
@@ -62,13 +73,16 @@ public:
      */
     virtual void draw() const;
 
+    /**
+     * @brief Replaces the board with the pattern stored in a RLE or
+     * Life 1.06 file.
+     */
+    void loadPattern( const std::string &path );
+
     int getBoardWidth() const;
 
 private:
 
-    void createNewGeneration();
-    int countNeighbors( int line, int column );
-
     /**
      * @brief Load game resources like images, textures, sounds, fonts, shaders,
      * etc.
@@ -0,0 +1,162 @@
+/**
+ * @file GridBoard.h
+ * @author Prof. Dr. David Buzatto
+ * @brief GridBoard class declaration. Abstract class for the boards that
+ * store a fixed grid of lines x columns cells and compute each generation
+ * into a second buffer.
+ * 
+ * The cells outside the board are read from a one-cell halo that is
+ * refreshed before each generation: zero-filled for a bounded board or
+ * copied from the opposite edge for a toroidal one.
+ * 
+ * The grid is divided in tiles. Only the tiles that changed in the last
+ * generation, and their neighbors, are computed again: a tile whose
+ * neighborhood did not change will not change either, and both buffers
+ * already hold its content. Disjoint lines of tiles can be computed at
+ * the same time by the threads of a pool.
+ * 
+ * The hash of the board is the sum of the hashes of its tiles, and only
+ * the tiles that changed since the last call are hashed again.
+ * 
+ * Each backend computes the tiles with a kernel chosen when the rule
+ * changes: the common rules have kernels specialized at compile time and
+ * the others use a table, so no rule is tested per cell.
+ * 
+ * @copyright Copyright (c) 2024
+ */
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <LifeBoard.h>
+#include <ThreadPool.h>
+
+class GridBoard : public LifeBoard {
+
+protected:
+
+    int tileHeight;
+    int tileWidth;
+    int tileLines;
+    int tileColumns;
+    bool torus;
+
+private:
+
+    std::vector<unsigned char> activeTiles;
+    std::vector<unsigned char> changedTiles;
+    int activeTileCount;
+    bool tileTracking;
+
+    std::vector<uint64_t> tileHashes;
+    std::vector<unsigned char> staleHashes;
+    uint64_t hash;
+
+public:
+
+    /**
+     * @brief Construct a new GridBoard object divided in tiles of
+     * tileHeight x tileWidth cells.
+     */
+    GridBoard( int lines, int columns, int tileHeight, int tileWidth );
+
+    /**
+     * @brief Destroy the GridBoard object.
+     */
+    virtual ~GridBoard();
+
+    /**
+     * @brief Computes the next generation of the whole board.
+     */
+    virtual void createNewGeneration();
+
+    /**
+     * @brief Computes the next generation of the whole board splitting the
+     * lines of tiles among the threads of the pool.
+     */
+    virtual void createNewGeneration( ThreadPool &threadPool );
+
+    /**
+     * @brief Enables or disables the tracking of active tiles. When it is
+     * disabled, every tile is computed in every generation.
+     */
+    void setTileTracking( bool tileTracking );
+    bool isTileTracking() const;
+
+    /**
+     * @brief Changes the rule and selects the kernel that computes it.
+     */
+    virtual bool setRule( const LifeRule &rule );
+
+    /**
+     * @brief Makes the board toroidal (the edges wrap around) or bounded
+     * (the cells outside the board are always dead).
+     */
+    void setTorus( bool torus );
+    bool isTorus() const;
+
+    /**
+     * @brief Returns a 64-bit hash of the cells of the current generation.
+     */
+    uint64_t getHash();
+
+    /**
+     * @brief Returns how many tiles were computed in the last generation.
+     */
+    int getActiveTileCount() const;
+    int getTileCount() const;
+
+protected:
+
+    /**
+     * @brief Refreshes the halo around the current generation according
+     * to the torus mode.
+     */
+    virtual void refreshHalo() = 0;
+
+    /**
+     * @brief Selects the kernel used by createNewTile for the current
+     * rule.
+     */
+    virtual void selectTileKernel() = 0;
+
+    /**
+     * @brief Computes the next generation of one tile without changing the
+     * current generation. Returns true if any cell of the tile changed.
+     */
+    virtual bool createNewTile( int tileLine, int tileColumn ) = 0;
+
+    /**
+     * @brief Makes the computed tiles the current generation.
+     */
+    virtual void swapGenerations() = 0;
+
+    /**
+     * @brief Returns a hash of the cells of one tile of the current
+     * generation.
+     */
+    virtual uint64_t hashTile( int tileLine, int tileColumn ) const = 0;
+
+    /**
+     * @brief Mixes value into a tile hash.
+     */
+    static uint64_t mixHash( uint64_t hash, uint64_t value );
+
+    /**
+     * @brief Must be called when a cell is edited, so its tile and the
+     * neighbor tiles are computed in the next generation.
+     */
+    void wakeTilesAround( int line, int column );
+
+    /**
+     * @brief Must be called when all the cells may have changed.
+     */
+    void wakeAllTiles();
+
+private:
+
+    void createNewTileLines( int startTileLine, int endTileLine );
+    void updateActiveTiles();
+    void wakeTilesAroundTile( int tileLine, int tileColumn );
+
+};
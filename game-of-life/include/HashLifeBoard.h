@@ -0,0 +1,117 @@
+/**
+ * @file HashLifeBoard.h
+ * @author Prof. Dr. David Buzatto
+ * @brief HashLifeBoard class declaration. Implements Bill Gosper's HashLife
+ * algorithm: the universe is a quadtree whose nodes are canonical (equal
+ * subtrees are stored only once) and memoize their own future, so regular
+ * patterns can be advanced by 2^k generations in a single step.
+ * 
+ * The universe is unbounded. The lines x columns of the board are only the
+ * window that is seen by getCell/setCell, centered at the origin.
+ * 
+ * @copyright Copyright (c) 2024
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <LifeBoard.h>
+
+class HashLifeBoard : public LifeBoard {
+
+    /**
+     * A node of level k represents a square of 2^k x 2^k cells. Level 0
+     * nodes are single cells.
+     */
+    struct Node {
+        Node *nw;
+        Node *ne;
+        Node *sw;
+        Node *se;
+        Node *result;
+        Node *next;
+        double population;
+        int level;
+        int resultStep;
+        bool marked;
+    };
+
+    std::vector<Node*> hashTable;
+    std::vector<Node*> blocks;
+    std::vector<Node*> emptyNodes;
+    Node *freeNodes;
+    size_t nodeCount;
+    size_t maxNodes;
+
+    Node *deadCell;
+    Node *liveCell;
+    Node *root;
+    int stepExponent;
+
+public:
+
+    /**
+     * @brief Construct a new HashLifeBoard object. When the number of nodes
+     * exceeds maxNodes after a step, the unreachable ones are collected.
+     */
+    HashLifeBoard( int lines, int columns, size_t maxNodes = 1 << 21 );
+
+    /**
+     * @brief Destroy the HashLifeBoard object.
+     */
+    ~HashLifeBoard();
+
+    /**
+     * @brief Advances the universe by 2^stepExponent generations.
+     */
+    virtual void createNewGeneration();
+
+    virtual bool getCell( int line, int column ) const;
+    virtual void setCell( int line, int column, bool alive );
+    virtual void clear();
+    virtual const char *getName() const;
+    virtual void readRegion( int line, int column, int height, int width, unsigned char *cells ) const;
+
+    /**
+     * @brief Finds the bounds of the live cells in the whole universe,
+     * walking only the nodes of the quadtree that can extend them.
+     */
+    virtual bool getLiveBounds( long long &top, long long &left, long long &bottom, long long &right ) const;
+
+    virtual bool setRule( const LifeRule &rule );
+
+    /**
+     * @brief Every cell can be stored, since the universe grows as needed.
+     */
+    virtual bool isInside( int line, int column ) const;
+
+    void setStepExponent( int stepExponent );
+    int getStepExponent() const;
+    double getPopulation() const;
+    size_t getNodeCount() const;
+
+private:
+
+    Node *allocateNode();
+    Node *join( Node *nw, Node *ne, Node *sw, Node *se );
+    Node *emptyNode( int level );
+    Node *expand( Node *node );
+    Node *centeredSubnode( Node *node );
+    Node *centeredHorizontal( Node *w, Node *e );
+    Node *centeredVertical( Node *n, Node *s );
+    Node *successor( Node *node, int step );
+    Node *successorBaseCase( Node *node );
+    Node *setCell( Node *node, int64_t x, int64_t y, bool alive );
+    bool getCell( const Node *node, int64_t x, int64_t y ) const;
+    void readRegion( const Node *node, int64_t x, int64_t y, int height, int width, unsigned char *cells ) const;
+    void findLiveBounds( const Node *node, int64_t x, int64_t y, bool &found,
+                         int64_t &minX, int64_t &minY, int64_t &maxX, int64_t &maxY ) const;
+    bool isPaddedForStep( const Node *node ) const;
+    void toUniverse( int line, int column, int64_t &x, int64_t &y ) const;
+
+    void resizeHashTable( size_t size );
+    void mark( Node *node, bool keepResults );
+    void collectGarbage( bool keepResults );
+
+};
@@ -0,0 +1,101 @@
+/**
+ * @file LifeBoard.h
+ * @author Prof. Dr. David Buzatto
+ * @brief LifeBoard class declaration. Abstract class that models the
+ * storage and evolution of a Game of Life board. Each backend decides
+ * how the cells are laid out in memory and how a new generation is
+ * computed.
+ * 
+ * @copyright Copyright (c) 2024
+ */
+#pragma once
+
+#include <vector>
+#include <ThreadPool.h>
+#include <LifeRule.h>
+
+class LifeBoard {
+
+protected:
+
+    int lines;
+    int columns;
+    unsigned long long generation;
+    LifeRule rule;
+
+public:
+
+    /**
+     * @brief Construct a new LifeBoard object.
+     */
+    LifeBoard( int lines, int columns );
+
+    /**
+     * @brief Destroy the LifeBoard object.
+     */
+    virtual ~LifeBoard();
+
+    /**
+     * @brief Advances the whole board by one step (one generation for the
+     * grid boards).
+     */
+    virtual void createNewGeneration() = 0;
+
+    /**
+     * @brief Advances the whole board by one step using the threads of the
+     * pool when the backend is able to. The result is the same of the
+     * single-threaded version.
+     */
+    virtual void createNewGeneration( ThreadPool &threadPool );
+
+    virtual bool getCell( int line, int column ) const = 0;
+    virtual void setCell( int line, int column, bool alive ) = 0;
+    virtual void clear() = 0;
+    virtual const char *getName() const = 0;
+
+    /**
+     * @brief Copies the height x width cells that start at (line, column)
+     * to cells (one byte per cell, line by line). Positions outside the
+     * board are read as dead cells.
+     */
+    virtual void readRegion( int line, int column, int height, int width, unsigned char *cells ) const;
+
+    /**
+     * @brief Finds the smallest rectangle (lines top to bottom, columns
+     * left to right) that holds every live cell. For unbounded boards
+     * it can go beyond the lines x columns window. Returns false if
+     * there is no live cell.
+     */
+    virtual bool getLiveBounds( long long &top, long long &left, long long &bottom, long long &right ) const;
+
+    /**
+     * @brief Copies every cell of the board to cells (one byte per cell,
+     * line by line).
+     */
+    void saveCells( std::vector<unsigned char> &cells ) const;
+
+    /**
+     * @brief Replaces every cell of the board with the content of cells
+     * (one byte per cell, line by line) and restarts the generation count.
+     */
+    void loadCells( const std::vector<unsigned char> &cells );
+
+    /**
+     * @brief Returns true if the cell at (line, column) can be stored.
+     */
+    virtual bool isInside( int line, int column ) const;
+
+    /**
+     * @brief Changes the rule used to create the next generations.
+     * Returns false, keeping the current rule, if the backend does not
+     * support the new one.
+     */
+    virtual bool setRule( const LifeRule &rule );
+    const LifeRule &getRule() const;
+
+    int getLines() const;
+    int getColumns() const;
+    unsigned long long getGeneration() const;
+    void setGeneration( unsigned long long generation );
+
+};
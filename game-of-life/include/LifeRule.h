@@ -0,0 +1,95 @@
+/**
+ * @file LifeRule.h
+ * @author Prof. Dr. David Buzatto
+ * @brief LifeRule class declaration. A Life-like rule (outer totalistic,
+ * Moore neighborhood) stored as two masks: the bit n of the birth mask is
+ * set if a dead cell with n live neighbors is born and the bit n of the
+ * survival mask is set if a live cell with n live neighbors survives.
+ * 
+ * @copyright Copyright (c) 2024
+ */
+#pragma once
+
+#include <string>
+
+/**
+ * @brief Returns the mask of the neighbor counts written as digits, for
+ * example neighborMask( "23" ).
+ */
+constexpr unsigned int neighborMask( const char *digits ) {
+    unsigned int mask = 0;
+    for ( ; *digits != '\0'; digits++ ) {
+        mask |= 1u << ( *digits - '0' );
+    }
+    return mask;
+}
+
+// the masks of the rules that have kernels specialized at compile time
+constexpr unsigned int CONWAY_BIRTH = neighborMask( "3" );
+constexpr unsigned int CONWAY_SURVIVAL = neighborMask( "23" );
+constexpr unsigned int HIGHLIFE_BIRTH = neighborMask( "36" );
+constexpr unsigned int HIGHLIFE_SURVIVAL = neighborMask( "23" );
+constexpr unsigned int DAY_AND_NIGHT_BIRTH = neighborMask( "3678" );
+constexpr unsigned int DAY_AND_NIGHT_SURVIVAL = neighborMask( "34678" );
+constexpr unsigned int SEEDS_BIRTH = neighborMask( "2" );
+constexpr unsigned int SEEDS_SURVIVAL = neighborMask( "" );
+constexpr unsigned int LIFE_WITHOUT_DEATH_BIRTH = neighborMask( "3" );
+constexpr unsigned int LIFE_WITHOUT_DEATH_SURVIVAL = neighborMask( "012345678" );
+constexpr unsigned int MORLEY_BIRTH = neighborMask( "368" );
+constexpr unsigned int MORLEY_SURVIVAL = neighborMask( "245" );
+constexpr unsigned int REPLICATOR_BIRTH = neighborMask( "1357" );
+constexpr unsigned int REPLICATOR_SURVIVAL = neighborMask( "1357" );
+
+class LifeRule {
+
+    unsigned int birth;
+    unsigned int survival;
+
+public:
+
+    /**
+     * @brief Construct a new LifeRule object with Conway's rule (B3/S23).
+     */
+    LifeRule();
+
+    /**
+     * @brief Construct a new LifeRule object from its masks.
+     */
+    LifeRule( unsigned int birth, unsigned int survival );
+
+    /**
+     * @brief Parses a rulestring in the B/S notation (B36/S23, case
+     * insensitive, the S part may come first) or in the S/B notation
+     * (23/36). Returns false if text is not a valid rulestring.
+     */
+    static bool parse( const char *text, LifeRule &rule );
+
+    /**
+     * @brief Returns the number of preset rules (the ones with specialized
+     * kernels) and one of them.
+     */
+    static int getPresetCount();
+    static LifeRule getPreset( int index );
+
+    unsigned int getBirth() const;
+    unsigned int getSurvival() const;
+
+    /**
+     * @brief Returns true if dead cells without live neighbors are born,
+     * which makes the empty space flash.
+     */
+    bool hasBirthOnZero() const;
+
+    /**
+     * @brief Returns the rulestring in the B/S notation.
+     */
+    std::string toString() const;
+
+    /**
+     * @brief Returns the usual name of the rule or an empty string.
+     */
+    const char *getName() const;
+
+    bool operator==( const LifeRule &other ) const;
+
+};
@@ -0,0 +1,37 @@
+/**
+ * @file PatternFile.h
+ * @author Prof. Dr. David Buzatto
+ * @brief Functions that load and save patterns in the RLE and Life 1.06
+ * formats.
+ * 
+ * The files are read through a fixed size buffer and each cell is placed
+ * as soon as it is parsed, so even multi-megabyte patterns are loaded
+ * without holding the text or the cells in memory.
+ * 
+ * @copyright Copyright (c) 2024
+ */
+#pragma once
+
+#include <LifeBoard.h>
+
+/**
+ * @brief Clears board and places the pattern stored in the file at path,
+ * restarting the generation count. The format is detected from the
+ * content: files that start with "#Life 1.06" are read as Life 1.06
+ * (coordinates relative to the center of the board) and the others as
+ * RLE (the pattern is centered on the board). Cells that do not fit the
+ * board are ignored and the rule of a RLE header, when present, becomes
+ * the rule of the board. Returns false and prints the reason if the file
+ * could not be read.
+ */
+bool loadPattern( LifeBoard &board, const char *path );
+
+/**
+ * @brief Saves the live cells of board (of the whole universe, for an
+ * unbounded board, even outside the lines x columns window) to the file
+ * at path, as Life 1.06 if the name ends with .lif or .life and as RLE
+ * otherwise. Returns false and prints the reason if the file could not
+ * be written or the pattern is too large. RLE files store the rule of
+ * the board in the header.
+ */
+bool savePattern( const LifeBoard &board, const char *path );
@@ -0,0 +1,21 @@
+/**
+ * @file Patterns.h
+ * @author Prof. Dr. David Buzatto
+ * @brief Functions that place initial patterns on a board.
+ * 
+ * @copyright Copyright (c) 2024
+ */
+#pragma once
+
+#include <LifeBoard.h>
+
+/**
+ * @brief Places the default seed (two oscillators) at the center of board.
+ */
+void placeDefaultPattern( LifeBoard &board );
+
+/**
+ * @brief Fills board with random cells, each one alive with probability
+ * density, using seed to make the soup reproducible.
+ */
+void placeRandomSoup( LifeBoard &board, double density, unsigned int seed );
@@ -0,0 +1,231 @@
+/**
+ * @file Simulation.h
+ * @author Prof. Dr. David Buzatto
+ * @brief Simulation class declaration. Runs the board in its own thread,
+ * at an interval chosen by the user or as fast as possible, so the
+ * generation rate does not depend on the frame rate.
+ * 
+ * The board belongs to the simulation thread. The user interface talks
+ * to it only through a lock-free command queue (edits, settings, board
+ * changes) and reads the finished generations from a lock-free triple
+ * buffer of snapshots, so neither thread waits for the other.
+ * 
+ * The grid boards are watched for cycles: the hash of each generation is
+ * kept in a ring and, when one repeats and the repetition is confirmed
+ * for a whole period, the simulation pauses or replays the stored
+ * generations of the cycle instead of computing them again.
+ * 
+ * @copyright Copyright (c) 2024
+ */
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <BoardType.h>
+#include <LifeBoard.h>
+#include <LifeRule.h>
+#include <ThreadPool.h>
+#include <TripleBuffer.h>
+#include <CommandQueue.h>
+#include <CycleDetector.h>
+
+/**
+ * @brief A copy of a finished generation, with everything the user
+ * interface shows about it.
+ */
+struct BoardSnapshot {
+    std::vector<unsigned char> cells;
+    unsigned long long generation = 0;
+    const char *boardName = "";
+    LifeRule rule;
+    bool gridBoard = false;
+    int activeTileCount = 0;
+    int tileCount = 0;
+    bool hashLife = false;
+    int stepExponent = 0;
+    double population = 0;
+    size_t nodeCount = 0;
+    double generationsPerSecond = 0;
+    int cyclePeriod = 0;
+    unsigned long long cycleStart = 0;
+    bool replaying = false;
+    unsigned int cycleStops = 0;
+};
+
+/**
+ * @brief What the simulation does when the board becomes periodic.
+ */
+enum CycleMode {
+    CYCLE_IGNORE,
+    CYCLE_PAUSE,
+    CYCLE_REPLAY
+};
+
+enum SimulationCommandType {
+    SET_CELL,
+    SET_RUNNING,
+    SET_INTERVAL,
+    SAVE_RESET_CELLS,
+    RESET,
+    SET_BOARD_TYPE,
+    SET_TILE_TRACKING,
+    SET_TORUS,
+    SET_PARALLEL_STEPPING,
+    CHANGE_STEP_EXPONENT,
+    SET_RULE,
+    SET_CYCLE_MODE,
+    LOAD_PATTERN,
+    SAVE_PATTERN
+};
+
+struct SimulationCommand {
+    SimulationCommandType type;
+    int line;
+    int column;
+    int value;
+    std::string path;
+};
+
+class Simulation {
+
+    static const unsigned int COMMAND_QUEUE_CAPACITY = 1 << 12;
+    static const int MAX_CYCLE_PERIOD = 64;
+
+    int lines;
+    int columns;
+
+    // owned by the simulation thread after the constructor returns
+    LifeBoard *board;
+    BoardType boardType;
+    std::vector<unsigned char> resetCells;
+    ThreadPool threadPool;
+    bool running;
+    std::chrono::microseconds interval;
+    bool tileTracking;
+    bool torus;
+    bool parallelStepping;
+    int stepExponent;
+    LifeRule rule;
+    double generationsPerSecond;
+
+    CycleMode cycleMode;
+    CycleDetector cycleDetector;
+    int confirmingPeriod;
+    int cyclePeriod;
+    unsigned long long cycleStart;
+    unsigned int cycleStops;
+
+    // the generations of the cycle, 64 cells per word, and the one shown
+    std::vector<std::vector<uint64_t>> cycleFrames;
+    std::vector<unsigned char> frameCells;
+    bool replaying;
+    int replayFrame;
+    unsigned long long replayGeneration;
+
+    CommandQueue<SimulationCommand, COMMAND_QUEUE_CAPACITY> commands;
+    TripleBuffer<BoardSnapshot> snapshots;
+    std::atomic<bool> stopping;
+    std::thread thread;
+
+public:
+
+    /**
+     * @brief Construct a new Simulation object with a board of the given
+     * type holding the default pattern and starts the simulation thread
+     * (paused).
+     */
+    Simulation( int lines, int columns, BoardType boardType, int threadCount );
+
+    /**
+     * @brief Destroy the Simulation object, stopping its thread.
+     */
+    ~Simulation();
+
+    /**
+     * @brief Queues a command to the simulation thread. Never waits:
+     * returns false if the queue is full.
+     */
+    bool send( const SimulationCommand &command );
+
+    bool setCell( int line, int column, bool alive );
+    bool setRunning( bool running );
+
+    /**
+     * @brief Sets the time between generations. Zero runs the simulation
+     * as fast as possible.
+     */
+    bool setInterval( double seconds );
+
+    /**
+     * @brief Saves the current cells to be restored by reset.
+     */
+    bool saveResetCells();
+    bool reset();
+    bool setBoardType( BoardType boardType );
+    bool setTileTracking( bool tileTracking );
+    bool setTorus( bool torus );
+    bool setParallelStepping( bool parallelStepping );
+    bool changeStepExponent( int delta );
+
+    /**
+     * @brief Changes the rule. A rule the board does not support is
+     * ignored (the snapshot shows the rule in use).
+     */
+    bool setRule( const LifeRule &rule );
+
+    /**
+     * @brief Chooses what happens when the board becomes periodic (up to
+     * period 64).
+     */
+    bool setCycleMode( CycleMode cycleMode );
+
+    /**
+     * @brief Replaces the board with the pattern stored in a RLE or
+     * Life 1.06 file. The simulation is paused.
+     */
+    bool loadPattern( const std::string &path );
+
+    /**
+     * @brief Saves the board to a RLE or Life 1.06 file.
+     */
+    bool savePattern( const std::string &path );
+
+    /**
+     * @brief Takes the last published snapshot, if there is a new one.
+     * Returns true if the snapshot changed. Never waits.
+     */
+    bool acquireSnapshot();
+
+    /**
+     * @brief Returns the last acquired snapshot. The cells hold the whole
+     * board, line by line.
+     */
+    const BoardSnapshot &getSnapshot() const;
+
+    int getLines() const;
+    int getColumns() const;
+    int getThreadCount() const;
+
+private:
+
+    void run();
+    bool executeCommands();
+    void execute( const SimulationCommand &command );
+    void applySettings();
+    void createNewGeneration();
+    bool detectCycle();
+    void captureCycleFrame();
+    void leaveReplay();
+    void resetCycleDetection();
+    unsigned long long getCurrentGeneration() const;
+    std::chrono::microseconds getStepInterval() const;
+    void fillSnapshot( BoardSnapshot &snapshot ) const;
+    LifeBoard *createBoard( BoardType boardType ) const;
+
+};
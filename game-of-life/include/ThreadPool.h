@@ -0,0 +1,57 @@
+/**
+ * @file ThreadPool.h
+ * @author Prof. Dr. David Buzatto
+ * @brief ThreadPool class declaration. A fixed set of worker threads,
+ * created once and reused, that execute batches of indexed tasks.
+ * 
+ * @copyright Copyright (c) 2024
+ */
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class ThreadPool {
+
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable batchStarted;
+    std::condition_variable batchFinished;
+
+    std::function<void( int )> task;
+    int taskCount;
+    int nextTask;
+    int pendingTasks;
+    unsigned long long batch;
+    bool stopping;
+
+public:
+
+    /**
+     * @brief Construct a new ThreadPool object, starting threadCount - 1
+     * worker threads (the thread that calls run also executes tasks).
+     */
+    ThreadPool( int threadCount );
+
+    /**
+     * @brief Destroy the ThreadPool object, joining all worker threads.
+     */
+    ~ThreadPool();
+
+    /**
+     * @brief Executes task( 0 ) ... task( taskCount - 1 ) using all threads
+     * and returns when all of them are finished.
+     */
+    void run( int taskCount, const std::function<void( int )> &task );
+
+    int getThreadCount() const;
+
+private:
+
+    void workerLoop();
+    bool executeNextTask( std::unique_lock<std::mutex> &lock );
+
+};
@@ -0,0 +1,82 @@
+/**
+ * @file TripleBuffer.h
+ * @author Prof. Dr. David Buzatto
+ * @brief TripleBuffer class declaration and implementation. Lets one
+ * producer thread publish complete values to one consumer thread without
+ * locks: the producer always owns a back buffer, the consumer always owns
+ * a front buffer and the third one, in the middle, is exchanged
+ * atomically by both. Neither side ever waits for the other.
+ * 
+ * @copyright Copyright (c) 2024
+ */
+#pragma once
+
+#include <atomic>
+
+template<typename T>
+class TripleBuffer {
+
+    // the middle index is stored with this bit set when it holds a value
+    // that was published and not acquired yet
+    static const int FRESH = 4;
+    static const int INDEX_MASK = 3;
+
+    T buffers[3];
+    std::atomic<int> middle;
+    int back;
+    int front;
+
+public:
+
+    /**
+     * @brief Construct a new TripleBuffer object.
+     */
+    TripleBuffer() :
+        middle( 1 ),
+        back( 0 ),
+        front( 2 ) {
+    }
+
+    /**
+     * @brief Returns the buffer the producer writes to.
+     */
+    T &getBack() {
+        return buffers[back];
+    }
+
+    /**
+     * @brief Returns true when the consumer already acquired the last
+     * published value, so publishing now does not discard any value.
+     */
+    bool isConsumed() const {
+        return ( middle.load( std::memory_order_acquire ) & FRESH ) == 0;
+    }
+
+    /**
+     * @brief Publishes the back buffer. Called by the producer.
+     */
+    void publish() {
+        back = middle.exchange( back | FRESH, std::memory_order_acq_rel ) & INDEX_MASK;
+    }
+
+    /**
+     * @brief Makes the last published value the front buffer, if there is
+     * a new one. Called by the consumer. Returns true if the front buffer
+     * changed.
+     */
+    bool acquire() {
+        if ( ( middle.load( std::memory_order_relaxed ) & FRESH ) == 0 ) {
+            return false;
+        }
+        front = middle.exchange( front, std::memory_order_acq_rel ) & INDEX_MASK;
+        return true;
+    }
+
+    /**
+     * @brief Returns the buffer the consumer reads from.
+     */
+    const T &getFront() const {
+        return buffers[front];
+    }
+
+};
@@ -7,10 +7,21 @@
  * @copyright Copyright (c) 2024
  */
 #include <GameWindow.h>
+#include <Benchmark.h>
 
-int main( void ) {
+int main( int argc, char **argv ) {
+
+    if ( isBenchmarkMode( argc, argv ) ) {
+        return runBenchmark( argc, argv );
+    }
 
     GameWindow gameWindow;
+
+    // the initial pattern may be given as a RLE or Life 1.06 file
+    if ( argc > 1 ) {
+        gameWindow.loadPattern( argv[1] );
+    }
+
     gameWindow.init();
 
     return 0;
@@ -0,0 +1,244 @@
+/**
+ * @file BigFloat.c
+ * @author Prof. Dr. David Buzatto
+ * @brief BigFloat implementation.
+ *
+ * @copyright Copyright (c) 2024
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+
+#include "BigFloat.h"
+
+static void addMagnitudes( uint32_t *result, const uint32_t *a, const uint32_t *b, int limbs );
+static void subMagnitudes( uint32_t *result, const uint32_t *a, const uint32_t *b, int limbs );
+static int compareMagnitudes( const uint32_t *a, const uint32_t *b, int limbs );
+static void addSigned( BigFloat *result, const BigFloat *a, const BigFloat *b, bool negateB );
+static void normalizeZero( BigFloat *x );
+
+/**
+ * @brief Creates a BigFloat with the value of a double (which must be
+ * smaller than 2^32 in magnitude) and limbs fractional digits.
+ */
+BigFloat bigFloatFromDouble( double value, int limbs ) {
+
+    BigFloat x;
+    memset( &x, 0, sizeof( BigFloat ) );
+    x.negative = value < 0;
+    x.limbs = limbs;
+
+    // each step moves the next 32 bits to the integer part, exactly
+    double magnitude = fabs( value );
+    for ( int k = 0; k <= limbs && magnitude > 0; k++ ) {
+        double digit = floor( magnitude );
+        x.digits[k] = (uint32_t) digit;
+        magnitude = ldexp( magnitude - digit, 32 );
+    }
+
+    normalizeZero( &x );
+    return x;
+
+}
+
+/**
+ * @brief Returns the double closest to x (truncated).
+ */
+double bigFloatToDouble( const BigFloat *x ) {
+
+    double value = 0;
+    for ( int k = x->limbs; k >= 0; k-- ) {
+        value += ldexp( x->digits[k], -32 * k );
+    }
+
+    return x->negative ? -value : value;
+
+}
+
+/**
+ * @brief Changes the number of fractional digits of x, truncating it or
+ * completing it with zeros.
+ */
+void setBigFloatLimbs( BigFloat *x, int limbs ) {
+    for ( int k = limbs + 1; k <= BIG_FLOAT_LIMBS; k++ ) {
+        x->digits[k] = 0;
+    }
+    x->limbs = limbs;
+    normalizeZero( x );
+}
+
+/**
+ * @brief Returns the number of fractional digits needed to locate points
+ * spaced by pixelSize without losing precision.
+ */
+int getBigFloatLimbsFor( double pixelSize ) {
+
+    // the bits of the pixel size plus 64 bits of margin
+    int bits = (int) ceil( -log2( pixelSize ) ) + 64;
+    int limbs = ( bits + 31 ) / 32;
+
+    if ( limbs < 2 ) {
+        return 2;
+    }
+    if ( limbs > BIG_FLOAT_LIMBS ) {
+        return BIG_FLOAT_LIMBS;
+    }
+    return limbs;
+
+}
+
+/**
+ * @brief result = a + b, with the precision of the most precise of them.
+ */
+void bigFloatAdd( BigFloat *result, const BigFloat *a, const BigFloat *b ) {
+    addSigned( result, a, b, false );
+}
+
+/**
+ * @brief result = a - b, with the precision of the most precise of them.
+ */
+void bigFloatSub( BigFloat *result, const BigFloat *a, const BigFloat *b ) {
+    addSigned( result, a, b, true );
+}
+
+/**
+ * @brief result = a * b, with the precision of the most precise of them.
+ */
+void bigFloatMul( BigFloat *result, const BigFloat *a, const BigFloat *b ) {
+
+    int limbs = a->limbs > b->limbs ? a->limbs : b->limbs;
+    uint32_t product[2*BIG_FLOAT_LIMBS+2];
+
+    // schoolbook multiplication; digit i of a times digit j of b weighs
+    // 2^(-32(i+j)), so it goes to product[i+j] and the carries move to
+    // the more significant digits (lower indexes). The integer part of
+    // the product must fit in 32 bits.
+    memset( product, 0, sizeof( uint32_t ) * ( 2 * limbs + 1 ) );
+    for ( int i = limbs; i >= 0; i-- ) {
+        uint64_t carry = 0;
+        for ( int j = limbs; j >= 0; j-- ) {
+            uint64_t t = (uint64_t) product[i+j] + (uint64_t) a->digits[i] * b->digits[j] + carry;
+            product[i+j] = (uint32_t) t;
+            carry = t >> 32;
+        }
+        if ( i > 0 ) {
+            product[i-1] = (uint32_t) carry;
+        }
+    }
+
+    bool negative = a->negative != b->negative;
+    memset( result->digits, 0, sizeof( result->digits ) );
+    memcpy( result->digits, product, sizeof( uint32_t ) * ( limbs + 1 ) );
+    result->limbs = limbs;
+    result->negative = negative;
+    normalizeZero( result );
+
+}
+
+/**
+ * @brief x = x + value, keeping the precision of x.
+ */
+void bigFloatAddDouble( BigFloat *x, double value ) {
+    BigFloat y = bigFloatFromDouble( value, x->limbs );
+    BigFloat sum;
+    bigFloatAdd( &sum, x, &y );
+    *x = sum;
+}
+
+/**
+ * @brief Returns true if a and b have the same value.
+ */
+bool bigFloatEquals( const BigFloat *a, const BigFloat *b ) {
+
+    if ( a->negative != b->negative ) {
+        return false;
+    }
+
+    int limbs = a->limbs > b->limbs ? a->limbs : b->limbs;
+    for ( int k = 0; k <= limbs; k++ ) {
+        uint32_t da = k <= a->limbs ? a->digits[k] : 0;
+        uint32_t db = k <= b->limbs ? b->digits[k] : 0;
+        if ( da != db ) {
+            return false;
+        }
+    }
+
+    return true;
+
+}
+
+static void addMagnitudes( uint32_t *result, const uint32_t *a, const uint32_t *b, int limbs ) {
+    uint64_t carry = 0;
+    for ( int k = limbs; k >= 0; k-- ) {
+        uint64_t t = (uint64_t) a[k] + b[k] + carry;
+        result[k] = (uint32_t) t;
+        carry = t >> 32;
+    }
+}
+
+/**
+ * @brief result = a - b for |a| >= |b|.
+ */
+static void subMagnitudes( uint32_t *result, const uint32_t *a, const uint32_t *b, int limbs ) {
+    uint64_t borrow = 0;
+    for ( int k = limbs; k >= 0; k-- ) {
+        uint64_t t = (uint64_t) a[k] - b[k] - borrow;
+        result[k] = (uint32_t) t;
+        borrow = ( t >> 32 ) & 1;
+    }
+}
+
+static int compareMagnitudes( const uint32_t *a, const uint32_t *b, int limbs ) {
+    for ( int k = 0; k <= limbs; k++ ) {
+        if ( a[k] != b[k] ) {
+            return a[k] < b[k] ? -1 : 1;
+        }
+    }
+    return 0;
+}
+
+static void addSigned( BigFloat *result, const BigFloat *a, const BigFloat *b, bool negateB ) {
+
+    int limbs = a->limbs > b->limbs ? a->limbs : b->limbs;
+
+    // digits beyond the precision of each operand are zero
+    BigFloat x = *a;
+    BigFloat y = *b;
+    setBigFloatLimbs( &x, limbs );
+    setBigFloatLimbs( &y, limbs );
+    y.negative = negateB ? !y.negative : y.negative;
+
+    result->limbs = limbs;
+    for ( int k = limbs + 1; k <= BIG_FLOAT_LIMBS; k++ ) {
+        result->digits[k] = 0;
+    }
+
+    if ( x.negative == y.negative ) {
+        addMagnitudes( result->digits, x.digits, y.digits, limbs );
+        result->negative = x.negative;
+    } else if ( compareMagnitudes( x.digits, y.digits, limbs ) >= 0 ) {
+        subMagnitudes( result->digits, x.digits, y.digits, limbs );
+        result->negative = x.negative;
+    } else {
+        subMagnitudes( result->digits, y.digits, x.digits, limbs );
+        result->negative = y.negative;
+    }
+
+    normalizeZero( result );
+
+}
+
+/**
+ * @brief Zero is always positive, so equal values have equal digits.
+ */
+static void normalizeZero( BigFloat *x ) {
+    for ( int k = 0; k <= x->limbs; k++ ) {
+        if ( x->digits[k] != 0 ) {
+            return;
+        }
+    }
+    x->negative = false;
+}
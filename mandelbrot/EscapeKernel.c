@@ -0,0 +1,364 @@
+/**
+ * @file EscapeKernel.c
+ * @author Prof. Dr. David Buzatto
+ * @brief Scalar and vectorized escape-time kernels.
+ *
+ * The vectorized kernels keep one point per lane. A lane whose point
+ * escaped keeps its last z, so it keeps failing the escape test and its
+ * iteration count stops growing; the loop ends when every lane escaped.
+ * They execute the same floating point operations, in the same order,
+ * as the scalar kernel, so the results are identical.
+ *
+ * Points inside the set would run all the iterations, so the kernels
+ * look for periodic orbits with Brent's method: z is saved at the
+ * iterations 1, 2, 4, 8, ... and compared with the next ones; an orbit
+ * that comes back to the saved point (within PERIODICITY_EPSILON) will
+ * never escape and is stopped, counting maxIterations.
+ *
+ * @copyright Copyright (c) 2024
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include "EscapeKernel.h"
+
+#if defined(__GNUC__) && ( defined(__x86_64__) || defined(__i386__) )
+#define X86_KERNELS
+#include <immintrin.h>
+#endif
+
+// a point that escapes before the first iteration, used to fill lanes
+#define ESCAPED_POINT 1e10
+
+// squared distance under which an orbit is considered back to a point
+#define PERIODICITY_EPSILON 1e-20
+
+int escapeScalar( const double *zx0, const double *zy0,
+                  const double *cx, const double *cy,
+                  int count, int maxIterations,
+                  double bailout, bool inclusive,
+                  int *iterations, double *zx, double *zy ) {
+
+    int periodic = 0;
+
+    for ( int k = 0; k < count; k++ ) {
+
+        double x = zx0[k];
+        double y = zy0[k];
+        double savedX = x;
+        double savedY = y;
+        int saveAt = 1;
+        double xTemp;
+        int iteration;
+
+        for ( iteration = 0;
+              iteration < maxIterations &&
+              ( inclusive ? x*x + y*y <= bailout : x*x + y*y < bailout );
+              iteration++ ) {
+            xTemp = x * x - y * y + cx[k];
+            y = 2 * x * y + cy[k];
+            x = xTemp;
+            double dx = x - savedX;
+            double dy = y - savedY;
+            if ( dx * dx + dy * dy < PERIODICITY_EPSILON ) {
+                iteration = maxIterations;
+                periodic++;
+                break;
+            }
+            if ( iteration + 1 == saveAt ) {
+                savedX = x;
+                savedY = y;
+                saveAt *= 2;
+            }
+        }
+
+        iterations[k] = iteration;
+        zx[k] = x;
+        zy[k] = y;
+
+    }
+
+    return periodic;
+
+}
+
+#ifdef X86_KERNELS
+
+__attribute__(( target( "avx2" ) ))
+static int escapeAVX2( const double *zx0, const double *zy0,
+                       const double *cx, const double *cy,
+                       int count, int maxIterations,
+                       double bailout, bool inclusive,
+                       int *iterations, double *zx, double *zy ) {
+
+    const __m256d two = _mm256_set1_pd( 2 );
+    const __m256d one = _mm256_set1_pd( 1 );
+    const __m256d limit = _mm256_set1_pd( bailout );
+    const __m256d epsilon = _mm256_set1_pd( PERIODICITY_EPSILON );
+    const __m256d all = _mm256_set1_pd( maxIterations );
+    int periodic = 0;
+
+    // two independent vectors per step hide the latency of each iteration
+    for ( int k = 0; k < count; k += 8 ) {
+
+        // the last group is completed with points that escape at once
+        double lanes[4][8];
+        for ( int l = 0; l < 8; l++ ) {
+            bool inside = k + l < count;
+            lanes[0][l] = inside ? zx0[k+l] : ESCAPED_POINT;
+            lanes[1][l] = inside ? zy0[k+l] : ESCAPED_POINT;
+            lanes[2][l] = inside ? cx[k+l] : 0;
+            lanes[3][l] = inside ? cy[k+l] : 0;
+        }
+
+        __m256d xa = _mm256_loadu_pd( lanes[0] );
+        __m256d xb = _mm256_loadu_pd( lanes[0] + 4 );
+        __m256d ya = _mm256_loadu_pd( lanes[1] );
+        __m256d yb = _mm256_loadu_pd( lanes[1] + 4 );
+        __m256d x0a = _mm256_loadu_pd( lanes[2] );
+        __m256d x0b = _mm256_loadu_pd( lanes[2] + 4 );
+        __m256d y0a = _mm256_loadu_pd( lanes[3] );
+        __m256d y0b = _mm256_loadu_pd( lanes[3] + 4 );
+        __m256d countsA = _mm256_setzero_pd();
+        __m256d countsB = _mm256_setzero_pd();
+        __m256d savedXA = xa;
+        __m256d savedXB = xb;
+        __m256d savedYA = ya;
+        __m256d savedYB = yb;
+        __m256d periodicA = _mm256_setzero_pd();   // lanes stopped as periodic
+        __m256d periodicB = _mm256_setzero_pd();
+        int saveAt = 1;
+
+        for ( int iteration = 0; iteration < maxIterations; iteration++ ) {
+
+            __m256d xxa = _mm256_mul_pd( xa, xa );
+            __m256d xxb = _mm256_mul_pd( xb, xb );
+            __m256d yya = _mm256_mul_pd( ya, ya );
+            __m256d yyb = _mm256_mul_pd( yb, yb );
+            __m256d activeA, activeB;
+            if ( inclusive ) {
+                activeA = _mm256_cmp_pd( _mm256_add_pd( xxa, yya ), limit, _CMP_LE_OQ );
+                activeB = _mm256_cmp_pd( _mm256_add_pd( xxb, yyb ), limit, _CMP_LE_OQ );
+            } else {
+                activeA = _mm256_cmp_pd( _mm256_add_pd( xxa, yya ), limit, _CMP_LT_OQ );
+                activeB = _mm256_cmp_pd( _mm256_add_pd( xxb, yyb ), limit, _CMP_LT_OQ );
+            }
+            activeA = _mm256_andnot_pd( periodicA, activeA );
+            activeB = _mm256_andnot_pd( periodicB, activeB );
+
+            if ( _mm256_movemask_pd( _mm256_or_pd( activeA, activeB ) ) == 0 ) {
+                break;
+            }
+
+            countsA = _mm256_add_pd( countsA, _mm256_and_pd( activeA, one ) );
+            countsB = _mm256_add_pd( countsB, _mm256_and_pd( activeB, one ) );
+            __m256d nxa = _mm256_add_pd( _mm256_sub_pd( xxa, yya ), x0a );
+            __m256d nxb = _mm256_add_pd( _mm256_sub_pd( xxb, yyb ), x0b );
+            __m256d nya = _mm256_add_pd( _mm256_mul_pd( _mm256_mul_pd( two, xa ), ya ), y0a );
+            __m256d nyb = _mm256_add_pd( _mm256_mul_pd( _mm256_mul_pd( two, xb ), yb ), y0b );
+            xa = _mm256_blendv_pd( xa, nxa, activeA );
+            xb = _mm256_blendv_pd( xb, nxb, activeB );
+            ya = _mm256_blendv_pd( ya, nya, activeA );
+            yb = _mm256_blendv_pd( yb, nyb, activeB );
+
+            __m256d dxa = _mm256_sub_pd( xa, savedXA );
+            __m256d dxb = _mm256_sub_pd( xb, savedXB );
+            __m256d dya = _mm256_sub_pd( ya, savedYA );
+            __m256d dyb = _mm256_sub_pd( yb, savedYB );
+            __m256d backA = _mm256_and_pd( activeA, _mm256_cmp_pd( 
+                _mm256_add_pd( _mm256_mul_pd( dxa, dxa ), _mm256_mul_pd( dya, dya ) ), epsilon, _CMP_LT_OQ ) );
+            __m256d backB = _mm256_and_pd( activeB, _mm256_cmp_pd( 
+                _mm256_add_pd( _mm256_mul_pd( dxb, dxb ), _mm256_mul_pd( dyb, dyb ) ), epsilon, _CMP_LT_OQ ) );
+            int backMaskA = _mm256_movemask_pd( backA );
+            int backMaskB = _mm256_movemask_pd( backB );
+            if ( backMaskA | backMaskB ) {
+                countsA = _mm256_blendv_pd( countsA, all, backA );
+                countsB = _mm256_blendv_pd( countsB, all, backB );
+                periodicA = _mm256_or_pd( periodicA, backA );
+                periodicB = _mm256_or_pd( periodicB, backB );
+                periodic += __builtin_popcount( backMaskA ) + __builtin_popcount( backMaskB );
+            }
+
+            if ( iteration + 1 == saveAt ) {
+                savedXA = xa;
+                savedXB = xb;
+                savedYA = ya;
+                savedYB = yb;
+                saveAt *= 2;
+            }
+
+        }
+
+        _mm256_storeu_pd( lanes[0], xa );
+        _mm256_storeu_pd( lanes[0] + 4, xb );
+        _mm256_storeu_pd( lanes[1], ya );
+        _mm256_storeu_pd( lanes[1] + 4, yb );
+        _mm256_storeu_pd( lanes[2], countsA );
+        _mm256_storeu_pd( lanes[2] + 4, countsB );
+        for ( int l = 0; l < 8 && k + l < count; l++ ) {
+            zx[k+l] = lanes[0][l];
+            zy[k+l] = lanes[1][l];
+            iterations[k+l] = (int) lanes[2][l];
+        }
+
+    }
+
+    return periodic;
+
+}
+
+__attribute__(( target( "avx512f" ) ))
+static int escapeAVX512( const double *zx0, const double *zy0,
+                         const double *cx, const double *cy,
+                         int count, int maxIterations,
+                         double bailout, bool inclusive,
+                         int *iterations, double *zx, double *zy ) {
+
+    const __m512d two = _mm512_set1_pd( 2 );
+    const __m512d one = _mm512_set1_pd( 1 );
+    const __m512d limit = _mm512_set1_pd( bailout );
+    const __m512d epsilon = _mm512_set1_pd( PERIODICITY_EPSILON );
+    const __m512d all = _mm512_set1_pd( maxIterations );
+    int periodic = 0;
+
+    // two independent vectors per step hide the latency of each iteration
+    for ( int k = 0; k < count; k += 16 ) {
+
+        // the last group is completed with points that escape at once
+        double lanes[4][16];
+        for ( int l = 0; l < 16; l++ ) {
+            bool inside = k + l < count;
+            lanes[0][l] = inside ? zx0[k+l] : ESCAPED_POINT;
+            lanes[1][l] = inside ? zy0[k+l] : ESCAPED_POINT;
+            lanes[2][l] = inside ? cx[k+l] : 0;
+            lanes[3][l] = inside ? cy[k+l] : 0;
+        }
+
+        __m512d xa = _mm512_loadu_pd( lanes[0] );
+        __m512d xb = _mm512_loadu_pd( lanes[0] + 8 );
+        __m512d ya = _mm512_loadu_pd( lanes[1] );
+        __m512d yb = _mm512_loadu_pd( lanes[1] + 8 );
+        __m512d x0a = _mm512_loadu_pd( lanes[2] );
+        __m512d x0b = _mm512_loadu_pd( lanes[2] + 8 );
+        __m512d y0a = _mm512_loadu_pd( lanes[3] );
+        __m512d y0b = _mm512_loadu_pd( lanes[3] + 8 );
+        __m512d countsA = _mm512_setzero_pd();
+        __m512d countsB = _mm512_setzero_pd();
+        __m512d savedXA = xa;
+        __m512d savedXB = xb;
+        __m512d savedYA = ya;
+        __m512d savedYB = yb;
+        __mmask8 periodicA = 0;     // lanes stopped as periodic
+        __mmask8 periodicB = 0;
+        int saveAt = 1;
+
+        for ( int iteration = 0; iteration < maxIterations; iteration++ ) {
+
+            __m512d xxa = _mm512_mul_pd( xa, xa );
+            __m512d xxb = _mm512_mul_pd( xb, xb );
+            __m512d yya = _mm512_mul_pd( ya, ya );
+            __m512d yyb = _mm512_mul_pd( yb, yb );
+            __mmask8 activeA, activeB;
+            if ( inclusive ) {
+                activeA = _mm512_cmp_pd_mask( _mm512_add_pd( xxa, yya ), limit, _CMP_LE_OQ );
+                activeB = _mm512_cmp_pd_mask( _mm512_add_pd( xxb, yyb ), limit, _CMP_LE_OQ );
+            } else {
+                activeA = _mm512_cmp_pd_mask( _mm512_add_pd( xxa, yya ), limit, _CMP_LT_OQ );
+                activeB = _mm512_cmp_pd_mask( _mm512_add_pd( xxb, yyb ), limit, _CMP_LT_OQ );
+            }
+            activeA &= ~periodicA;
+            activeB &= ~periodicB;
+
+            if ( ( activeA | activeB ) == 0 ) {
+                break;
+            }
+
+            countsA = _mm512_mask_add_pd( countsA, activeA, countsA, one );
+            countsB = _mm512_mask_add_pd( countsB, activeB, countsB, one );
+            __m512d nxa = _mm512_add_pd( _mm512_sub_pd( xxa, yya ), x0a );
+            __m512d nxb = _mm512_add_pd( _mm512_sub_pd( xxb, yyb ), x0b );
+            __m512d nya = _mm512_add_pd( _mm512_mul_pd( _mm512_mul_pd( two, xa ), ya ), y0a );
+            __m512d nyb = _mm512_add_pd( _mm512_mul_pd( _mm512_mul_pd( two, xb ), yb ), y0b );
+            xa = _mm512_mask_mov_pd( xa, activeA, nxa );
+            xb = _mm512_mask_mov_pd( xb, activeB, nxb );
+            ya = _mm512_mask_mov_pd( ya, activeA, nya );
+            yb = _mm512_mask_mov_pd( yb, activeB, nyb );
+
+            __m512d dxa = _mm512_sub_pd( xa, savedXA );
+            __m512d dxb = _mm512_sub_pd( xb, savedXB );
+            __m512d dya = _mm512_sub_pd( ya, savedYA );
+            __m512d dyb = _mm512_sub_pd( yb, savedYB );
+            __mmask8 backA = _mm512_mask_cmp_pd_mask( activeA, 
+                _mm512_add_pd( _mm512_mul_pd( dxa, dxa ), _mm512_mul_pd( dya, dya ) ), epsilon, _CMP_LT_OQ );
+            __mmask8 backB = _mm512_mask_cmp_pd_mask( activeB, 
+                _mm512_add_pd( _mm512_mul_pd( dxb, dxb ), _mm512_mul_pd( dyb, dyb ) ), epsilon, _CMP_LT_OQ );
+            if ( backA | backB ) {
+                countsA = _mm512_mask_mov_pd( countsA, backA, all );
+                countsB = _mm512_mask_mov_pd( countsB, backB, all );
+                periodicA |= backA;
+                periodicB |= backB;
+                periodic += __builtin_popcount( backA ) + __builtin_popcount( backB );
+            }
+
+            if ( iteration + 1 == saveAt ) {
+                savedXA = xa;
+                savedXB = xb;
+                savedYA = ya;
+                savedYB = yb;
+                saveAt *= 2;
+            }
+
+        }
+
+        _mm512_storeu_pd( lanes[0], xa );
+        _mm512_storeu_pd( lanes[0] + 8, xb );
+        _mm512_storeu_pd( lanes[1], ya );
+        _mm512_storeu_pd( lanes[1] + 8, yb );
+        _mm512_storeu_pd( lanes[2], countsA );
+        _mm512_storeu_pd( lanes[2] + 8, countsB );
+        for ( int l = 0; l < 16 && k + l < count; l++ ) {
+            zx[k+l] = lanes[0][l];
+            zy[k+l] = lanes[1][l];
+            iterations[k+l] = (int) lanes[2][l];
+        }
+
+    }
+
+    return periodic;
+
+}
+
+#endif
+
+/**
+ * @brief Returns the fastest kernel the processor supports.
+ */
+EscapeKernel getEscapeKernel( void ) {
+#ifdef X86_KERNELS
+    __builtin_cpu_init();
+    if ( __builtin_cpu_supports( "avx512f" ) ) {
+        return escapeAVX512;
+    }
+    if ( __builtin_cpu_supports( "avx2" ) ) {
+        return escapeAVX2;
+    }
+#endif
+    return escapeScalar;
+}
+
+/**
+ * @brief Returns the name of the kernel returned by getEscapeKernel.
+ */
+const char *getEscapeKernelName( void ) {
+#ifdef X86_KERNELS
+    EscapeKernel kernel = getEscapeKernel();
+    if ( kernel == escapeAVX512 ) {
+        return "AVX-512";
+    }
+    if ( kernel == escapeAVX2 ) {
+        return "AVX2";
+    }
+#endif
+    return "escalar";
+}
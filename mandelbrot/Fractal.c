@@ -0,0 +1,604 @@
+/**
+ * @file Fractal.c
+ * @author Prof. Dr. David Buzatto
+ * @brief Escape-time computation and coloring of the Mandelbrot and
+ * Julia fractals.
+ *
+ * @copyright Copyright (c) 2024
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <math.h>
+
+#include "Fractal.h"
+#include "EscapeKernel.h"
+
+#include "raylib.h"
+#include "raymath.h"
+
+// state shared by the steps of the subdivision of a rectangle
+typedef struct Subdivision {
+    const FractalParams *params;
+    EscapeKernel kernel;
+    const ReferenceOrbit *orbit;
+    int width;
+    int height;
+    int *iterations;
+    double *smooth;
+    bool *filled;
+    FractalCounters *counters;
+} Subdivision;
+
+static void reservePalette( FractalPalette *palette, int maxIterations );
+static Color getPaletteColor( const FractalParams *params, double fraction );
+static int paletteIndex( const FractalPalette *palette, int iteration );
+static bool isInMainCardioidOrBulb( double x, double y );
+static void computeSubdivisionPoints( Subdivision *s, const int *lines, const int *columns, int count );
+static void computeSubdivisionRow( Subdivision *s, int line, int startColumn, int endColumn );
+static void computeSubdivisionColumns( Subdivision *s, int firstColumn, int secondColumn, 
+                                       int startLine, int endLine );
+static void subdivide( Subdivision *s, int top, int left, int bottom, int right );
+static void fillRectangle( Subdivision *s, int top, int left, int bottom, int right );
+
+/**
+ * @brief Computes the escape time of the pixels startColumn to endColumn
+ * - 1 (at most MAX_ROW_LENGTH) of the line py of a width x height image
+ * of the fractal: the iteration count and the smooth (fractional) value
+ * derived from the last |z|^2. orbit is the reference orbit of the center
+ * when params use perturbation. The pixels that skipped the iteration are
+ * added to counters.
+ */
+void computeFractalRow( const FractalParams *params, EscapeKernel kernel,
+                        const ReferenceOrbit *orbit,
+                        int py, int startColumn, int endColumn,
+                        int width, int height, 
+                        int *iterations, double *smooth,
+                        FractalCounters *counters ) {
+
+    int lines[MAX_ROW_LENGTH];
+    int columns[MAX_ROW_LENGTH];
+    int count = endColumn - startColumn;
+
+    for ( int k = 0; k < count; k++ ) {
+        lines[k] = py;
+        columns[k] = startColumn + k;
+    }
+
+    computeFractalPoints( params, kernel, orbit, lines, columns, count, width, height, 
+                          iterations, smooth, counters );
+
+}
+
+/**
+ * @brief Computes the escape time of count (at most MAX_ROW_LENGTH)
+ * pixels of any lines and columns of a width x height image, like
+ * computeFractalRow.
+ */
+void computeFractalPoints( const FractalParams *params, EscapeKernel kernel,
+                           const ReferenceOrbit *orbit,
+                           const int *lines, const int *columns, int count,
+                           int width, int height, 
+                           int *iterations, double *smooth,
+                           FractalCounters *counters ) {
+
+    double xs[MAX_ROW_LENGTH];
+    double ys[MAX_ROW_LENGTH];
+
+    for ( int k = 0; k < count; k++ ) {
+        xs[k] = Lerp( params->minX, params->maxX, ( columns[k] / (double) width ) );  // real
+        ys[k] = Lerp( params->minY, params->maxY, ( lines[k] / (double) height ) );  // imaginary
+    }
+
+    computeFractalSamples( params, kernel, orbit, xs, ys, count, 
+                           iterations, smooth, counters );
+
+}
+
+/**
+ * @brief Computes the escape time of count (at most MAX_ROW_LENGTH)
+ * points x + y*i of the complex plane (offsets from the center with
+ * perturbation), like computeFractalRow.
+ */
+void computeFractalSamples( const FractalParams *params, EscapeKernel kernel,
+                            const ReferenceOrbit *orbit,
+                            const double *x, const double *y, int count,
+                            int *iterations, double *smooth,
+                            FractalCounters *counters ) {
+
+    // based on https://en.wikipedia.org/wiki/Mandelbrot_set
+    //          https://en.wikipedia.org/wiki/Julia_set
+
+    double xs[MAX_ROW_LENGTH];
+    double ys[MAX_ROW_LENGTH];
+    double cxs[MAX_ROW_LENGTH];
+    double cys[MAX_ROW_LENGTH];
+    double zeros[MAX_ROW_LENGTH] = { 0 };
+    double zx[MAX_ROW_LENGTH];
+    double zy[MAX_ROW_LENGTH];
+    int maxIterations = params->maxIterations;
+
+    if ( params->perturbation ) {
+
+        // offsets from the center, in double precision since they can
+        // be way smaller than the smallest float
+        escapePerturbed( orbit, x, y, count, maxIterations, 1 << 16, iterations, zx, zy );
+        counters->iterated += count;
+
+    } else {
+
+        // the point of each pixel is the fixed complex number (c) in the
+        // Mandelbrot set and the varying one (z) in the Julia set
+        for ( int k = 0; k < count; k++ ) {
+            xs[k] = x[k];
+            ys[k] = y[k];
+            cxs[k] = params->cx;
+            cys[k] = params->cy;
+        }
+
+        if ( params->mandelbrot ) {
+
+            // the points inside the main cardioid and the period-2 bulb
+            // never escape; only the others (packed at the start of the
+            // arrays) are iterated, and then moved back to their pixels
+            int packed[MAX_ROW_LENGTH];
+            int outside = 0;
+            for ( int k = 0; k < count; k++ ) {
+                if ( isInMainCardioidOrBulb( xs[k], ys[k] ) ) {
+                    iterations[k] = maxIterations;
+                    zx[k] = 0;
+                    zy[k] = 0;
+                } else {
+                    packed[outside] = k;
+                    xs[outside] = xs[k];
+                    ys[outside] = ys[k];
+                    outside++;
+                }
+            }
+            counters->interior += count - outside;
+            counters->iterated += outside;
+
+            if ( outside > 0 ) {
+                int packedIterations[MAX_ROW_LENGTH];
+                double packedZx[MAX_ROW_LENGTH];
+                double packedZy[MAX_ROW_LENGTH];
+                counters->periodic += kernel( zeros, zeros, xs, ys, outside, maxIterations, 
+                                              1 << 16, true, packedIterations, packedZx, packedZy );
+                for ( int k = 0; k < outside; k++ ) {
+                    iterations[packed[k]] = packedIterations[k];
+                    zx[packed[k]] = packedZx[k];
+                    zy[packed[k]] = packedZy[k];
+                }
+            }
+
+        } else {
+            counters->periodic += kernel( xs, ys, cxs, cys, count, maxIterations, 
+                                          params->scapeRadius * params->scapeRadius, false, 
+                                          iterations, zx, zy );
+            counters->iterated += count;
+        }
+
+    }
+
+    for ( int k = 0; k < count; k++ ) {
+        double diff = 0;
+        if ( iterations[k] < maxIterations ) {
+            double logZn = log( zx[k] * zx[k] + zy[k] * zy[k] ) / 2;
+            double nu = log( logZn / log(2) ) / log(2);
+            diff = iterations[k] - 1 - nu;
+        }
+        smooth[k] = diff;
+    }
+
+}
+
+/**
+ * @brief Computes the escape times of the rectangle of lines startLine
+ * to endLine - 1 and columns startColumn to endColumn - 1 of a width x
+ * height image of the Mandelbrot set by Mariani-Silver subdivision: only
+ * the border of the rectangle is iterated; if every pixel of the border
+ * has the same iteration count the interior is filled with it, otherwise
+ * the rectangle is split in two and each half is processed the same way.
+ * iterations, smooth and filled hold the whole image; filled marks the
+ * pixels that were filled instead of iterated. The rectangle can have at
+ * most MAX_SUBDIVISION_SIZE lines.
+ */
+void computeFractalRectangle( const FractalParams *params, EscapeKernel kernel,
+                              const ReferenceOrbit *orbit,
+                              int startLine, int endLine, int startColumn, int endColumn,
+                              int width, int height,
+                              int *iterations, double *smooth, bool *filled,
+                              FractalCounters *counters ) {
+
+    // based on https://mrob.com/pub/muency/marianisilveralgorithm.html
+    Subdivision s = {
+        .params = params,
+        .kernel = kernel,
+        .orbit = orbit,
+        .width = width,
+        .height = height,
+        .iterations = iterations,
+        .smooth = smooth,
+        .filled = filled,
+        .counters = counters
+    };
+
+    int top = startLine;
+    int left = startColumn;
+    int bottom = endLine - 1;
+    int right = endColumn - 1;
+
+    computeSubdivisionRow( &s, top, left, right + 1 );
+    if ( bottom > top ) {
+        computeSubdivisionRow( &s, bottom, left, right + 1 );
+    }
+    if ( bottom - top > 1 ) {
+        computeSubdivisionColumns( &s, left, right, top + 1, bottom );
+    }
+
+    subdivide( &s, top, left, bottom, right );
+
+}
+
+/**
+ * @brief Computes the colors of count pixels from their escape times.
+ */
+void colorFractalRow( const FractalParams *params, const FractalPalette *palette,
+                      const int *iterations, const double *smooth, 
+                      int count, Color *colors ) {
+
+    const Color *paletteColors = palette->colors;
+    double maxIterations = params->maxIterations;
+
+    if ( params->gradient ) {
+
+        for ( int k = 0; k < count; k++ ) {
+
+            double diff = smooth[k];
+            double fraction = diff - ((long)diff);
+
+            if ( params->colored || params->histogram ) {
+                Color color1 = paletteColors[paletteIndex( palette, (int) diff )];
+                Color color2 = paletteColors[paletteIndex( palette, (int) (diff+1) )];
+                colors[k] = (Color) {
+                    .r = Lerp( color1.r, color2.r, fraction ),
+                    .g = Lerp( color1.g, color2.g, fraction ),
+                    .b = Lerp( color1.b, color2.b, fraction ),
+                    .a = 255
+                };
+            } else {
+                double c1 = 255 * (diff) / maxIterations;
+                double c2 = 255 * (diff+1) / maxIterations;
+                unsigned char c = (int) Lerp( c1, c2, fraction );
+                colors[k] = (Color) { c, c, c, 255 };
+            }
+
+        }
+
+    } else {
+        for ( int k = 0; k < count; k++ ) {
+            colors[k] = paletteColors[paletteIndex( palette, iterations[k] )];
+        }
+    }
+
+}
+
+/**
+ * @brief Fills the palette for the coloring of params.
+ */
+void updateFractalPalette( FractalPalette *palette, const FractalParams *params ) {
+
+    int maxIterations = params->maxIterations;
+
+    reservePalette( palette, maxIterations );
+
+    for ( int k = -PALETTE_MARGIN; k <= maxIterations + 1; k++ ) {
+        palette->colors[PALETTE_MARGIN+k] = getPaletteColor( params, k / (double) maxIterations );
+    }
+
+}
+
+/**
+ * @brief Fills the palette for the histogram coloring of params, where
+ * cumulative[k] is how many escaped pixels took less than k iterations,
+ * for k from 0 to maxIterations (that is, the count of all of them).
+ */
+void updateFractalHistogramPalette( FractalPalette *palette, const FractalParams *params,
+                                    const int *cumulative ) {
+
+    // based on https://en.wikipedia.org/wiki/Plotting_algorithms_for_the_Mandelbrot_set#Histogram_coloring
+    int maxIterations = params->maxIterations;
+    double total = cumulative[maxIterations] > 0 ? cumulative[maxIterations] : 1;
+
+    reservePalette( palette, maxIterations );
+
+    for ( int k = -PALETTE_MARGIN; k <= maxIterations + 1; k++ ) {
+        double fraction = k <= 0 ? 0 : 
+                          k >= maxIterations ? 1 : cumulative[k] / total;
+        palette->colors[PALETTE_MARGIN+k] = getPaletteColor( params, fraction );
+    }
+
+}
+
+/**
+ * @brief Frees the colors of the palette.
+ */
+void freeFractalPalette( FractalPalette *palette ) {
+    free( palette->colors );
+    palette->colors = NULL;
+    palette->capacity = 0;
+}
+
+/**
+ * @brief Returns which parts of the image change from oldParams to
+ * newParams, as a combination of FractalChange flags.
+ */
+int getFractalChanges( const FractalParams *oldParams, const FractalParams *newParams ) {
+
+    int changes = FRACTAL_UNCHANGED;
+
+    if ( oldParams->minX != newParams->minX || oldParams->maxX != newParams->maxX ||
+         oldParams->minY != newParams->minY || oldParams->maxY != newParams->maxY ||
+         oldParams->mandelbrot != newParams->mandelbrot ||
+         oldParams->maxIterations != newParams->maxIterations ||
+         oldParams->scapeRadius != newParams->scapeRadius ||
+         ( !newParams->mandelbrot && 
+           ( oldParams->cx != newParams->cx || oldParams->cy != newParams->cy ) ) ||
+         oldParams->perturbation != newParams->perturbation ||
+         ( newParams->perturbation &&
+           ( !bigFloatEquals( &oldParams->centerX, &newParams->centerX ) ||
+             !bigFloatEquals( &oldParams->centerY, &newParams->centerY ) ) ) ||
+         ( newParams->mandelbrot && oldParams->subdivision != newParams->subdivision ) ) {
+        changes |= FRACTAL_VIEW_CHANGED;
+    }
+
+    if ( oldParams->colored != newParams->colored ||
+         oldParams->gradient != newParams->gradient ||
+         oldParams->showSubdivision != newParams->showSubdivision ||
+         oldParams->histogram != newParams->histogram ||
+         oldParams->antialiasing != newParams->antialiasing ||
+         ( newParams->colored &&
+           ( oldParams->hueStart != newParams->hueStart || oldParams->hueEnd != newParams->hueEnd ) ) ) {
+        changes |= FRACTAL_COLORS_CHANGED;
+    }
+
+    return changes;
+
+}
+
+/**
+ * @brief Returns true if c = x + y*i is inside the main cardioid or the
+ * period-2 bulb of the Mandelbrot set.
+ */
+static bool isInMainCardioidOrBulb( double x, double y ) {
+
+    // based on https://en.wikipedia.org/wiki/Plotting_algorithms_for_the_Mandelbrot_set
+    double yy = y * y;
+    double q = ( x - 0.25 ) * ( x - 0.25 ) + yy;
+    if ( q * ( q + ( x - 0.25 ) ) <= 0.25 * yy ) {
+        return true;
+    }
+
+    return ( x + 1 ) * ( x + 1 ) + yy <= 0.0625;
+
+}
+
+/**
+ * @brief Iterates count pixels of any lines and columns, in groups of
+ * MAX_ROW_LENGTH, so the vectorized kernels have every lane busy.
+ */
+static void computeSubdivisionPoints( Subdivision *s, const int *lines, const int *columns, int count ) {
+
+    int iterations[MAX_ROW_LENGTH];
+    double smooth[MAX_ROW_LENGTH];
+
+    for ( int start = 0; start < count; start += MAX_ROW_LENGTH ) {
+        int groupCount = count - start < MAX_ROW_LENGTH ? count - start : MAX_ROW_LENGTH;
+        computeFractalPoints( s->params, s->kernel, s->orbit, &lines[start], &columns[start], 
+                              groupCount, s->width, s->height, iterations, smooth, s->counters );
+        for ( int k = 0; k < groupCount; k++ ) {
+            int index = lines[start+k] * s->width + columns[start+k];
+            s->iterations[index] = iterations[k];
+            s->smooth[index] = smooth[k];
+            s->filled[index] = false;
+        }
+    }
+
+}
+
+/**
+ * @brief Iterates the pixels startColumn to endColumn - 1 of a line.
+ */
+static void computeSubdivisionRow( Subdivision *s, int line, int startColumn, int endColumn ) {
+
+    int index = line * s->width;
+
+    for ( int j = startColumn; j < endColumn; j += MAX_ROW_LENGTH ) {
+        int end = j + MAX_ROW_LENGTH < endColumn ? j + MAX_ROW_LENGTH : endColumn;
+        computeFractalRow( s->params, s->kernel, s->orbit, line, j, end, s->width, s->height,
+                           &s->iterations[index+j], &s->smooth[index+j], s->counters );
+        for ( int k = j; k < end; k++ ) {
+            s->filled[index+k] = false;
+        }
+    }
+
+}
+
+/**
+ * @brief Iterates the pixels startLine to endLine - 1 of two columns (of
+ * one, if they are the same), together.
+ */
+static void computeSubdivisionColumns( Subdivision *s, int firstColumn, int secondColumn, 
+                                       int startLine, int endLine ) {
+
+    int lines[2*MAX_SUBDIVISION_SIZE];
+    int columns[2*MAX_SUBDIVISION_SIZE];
+    int count = 0;
+
+    for ( int i = startLine; i < endLine; i++ ) {
+        lines[count] = i;
+        columns[count++] = firstColumn;
+        if ( secondColumn != firstColumn ) {
+            lines[count] = i;
+            columns[count++] = secondColumn;
+        }
+    }
+
+    computeSubdivisionPoints( s, lines, columns, count );
+
+}
+
+/**
+ * @brief Processes the interior of the rectangle from ( top, left ) to
+ * ( bottom, right ), inclusive, whose border is already computed.
+ */
+static void subdivide( Subdivision *s, int top, int left, int bottom, int right ) {
+
+    if ( bottom - top < 2 || right - left < 2 ) {
+        return;
+    }
+
+    const int *iterations = s->iterations;
+    int width = s->width;
+    int iteration = iterations[top*width+left];
+    bool uniform = true;
+
+    for ( int j = left; j <= right && uniform; j++ ) {
+        uniform = iterations[top*width+j] == iteration && iterations[bottom*width+j] == iteration;
+    }
+    for ( int i = top + 1; i < bottom && uniform; i++ ) {
+        uniform = iterations[i*width+left] == iteration && iterations[i*width+right] == iteration;
+    }
+
+    if ( uniform ) {
+        fillRectangle( s, top, left, bottom, right );
+        return;
+    }
+
+    // small interiors are cheaper to iterate than to split again
+    if ( bottom - top <= 4 && right - left <= 4 ) {
+        int lines[9];
+        int columns[9];
+        int count = 0;
+        for ( int i = top + 1; i < bottom; i++ ) {
+            for ( int j = left + 1; j < right; j++ ) {
+                lines[count] = i;
+                columns[count++] = j;
+            }
+        }
+        computeSubdivisionPoints( s, lines, columns, count );
+        return;
+    }
+
+    // the longest side is split; the new line is the border of both halves
+    if ( right - left >= bottom - top ) {
+        int middle = ( left + right ) / 2;
+        computeSubdivisionColumns( s, middle, middle, top + 1, bottom );
+        subdivide( s, top, left, bottom, middle );
+        subdivide( s, top, middle, bottom, right );
+    } else {
+        int middle = ( top + bottom ) / 2;
+        computeSubdivisionRow( s, middle, left + 1, right );
+        subdivide( s, top, left, middle, right );
+        subdivide( s, middle, left, bottom, right );
+    }
+
+}
+
+/**
+ * @brief Fills the interior of a rectangle whose border has a single
+ * iteration count. The smooth values of escaped pixels vary inside a
+ * band, so they are interpolated from the four sides (a bilinear Coons
+ * patch) to keep the gradient coloring continuous.
+ */
+static void fillRectangle( Subdivision *s, int top, int left, int bottom, int right ) {
+
+    int width = s->width;
+    int iteration = s->iterations[top*width+left];
+    const double *smooth = s->smooth;
+    double topLeft = smooth[top*width+left];
+    double topRight = smooth[top*width+right];
+    double bottomLeft = smooth[bottom*width+left];
+    double bottomRight = smooth[bottom*width+right];
+
+    for ( int i = top + 1; i < bottom; i++ ) {
+
+        double v = ( i - top ) / (double) ( bottom - top );
+        double leftValue = smooth[i*width+left];
+        double rightValue = smooth[i*width+right];
+
+        for ( int j = left + 1; j < right; j++ ) {
+
+            double u = ( j - left ) / (double) ( right - left );
+            double value = 0;
+
+            if ( iteration < s->params->maxIterations ) {
+                value = ( 1 - u ) * leftValue + u * rightValue +
+                        ( 1 - v ) * smooth[top*width+j] + v * smooth[bottom*width+j] -
+                        ( ( 1 - u ) * ( 1 - v ) * topLeft + u * ( 1 - v ) * topRight +
+                          ( 1 - u ) * v * bottomLeft + u * v * bottomRight );
+            }
+
+            s->iterations[i*width+j] = iteration;
+            s->smooth[i*width+j] = value;
+            s->filled[i*width+j] = true;
+
+        }
+
+    }
+
+    s->counters->filled += ( bottom - top - 1 ) * ( right - left - 1 );
+
+}
+
+/**
+ * @brief Makes room in the palette for the iteration counts up to
+ * maxIterations.
+ */
+static void reservePalette( FractalPalette *palette, int maxIterations ) {
+
+    int size = maxIterations + 2 + PALETTE_MARGIN;
+
+    if ( size > palette->capacity ) {
+        free( palette->colors );
+        palette->colors = (Color*) malloc( sizeof( Color ) * size );
+        palette->capacity = size;
+    }
+    palette->maxIterations = maxIterations;
+
+}
+
+/**
+ * @brief Color at fraction (0 to 1, a little beyond at the margins) of
+ * the coloring of params.
+ */
+static Color getPaletteColor( const FractalParams *params, double fraction ) {
+
+    Color color = { 0, 0, 0, 255 };
+
+    if ( params->colored ) {
+        color = ColorFromHSV( params->hueStart +
+            ( params->hueEnd - params->hueStart ) * fraction,
+            1, 0.7 );
+    } else {
+        int c = 255 - 255 * fraction;
+        color.r = c;
+        color.g = c;
+        color.b = c;
+    }
+
+    return color;
+
+}
+
+/**
+ * @brief Position of the color of iteration in the palette.
+ */
+static int paletteIndex( const FractalPalette *palette, int iteration ) {
+    if ( iteration < -PALETTE_MARGIN ) {
+        iteration = -PALETTE_MARGIN;
+    } else if ( iteration > palette->maxIterations + 1 ) {
+        iteration = palette->maxIterations + 1;
+    }
+    return PALETTE_MARGIN + iteration;
+}
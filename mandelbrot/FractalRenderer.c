@@ -0,0 +1,856 @@
+/**
+ * @file FractalRenderer.c
+ * @author Prof. Dr. David Buzatto
+ * @brief FractalRenderer implementation.
+ *
+ * @copyright Copyright (c) 2024
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "FractalRenderer.h"
+#include "EscapeKernel.h"
+#include "Fractal.h"
+#include "ThreadPool.h"
+#include "Perturbation.h"
+
+#include "raylib.h"
+#include "raymath.h"
+
+// pixels supersampled by each call to the escape-time function
+#define SUPERSAMPLED_PIXELS ( MAX_ROW_LENGTH / ( SUPERSAMPLING_GRID * SUPERSAMPLING_GRID ) )
+
+static void startRenderPass( FractalRenderer *renderer );
+static void startRefinement( FractalRenderer *renderer );
+static void updateHistogramPalette( FractalRenderer *renderer );
+static void countIterations( void *data, int task, int worker );
+static void sumIterationCounts( void *data, int task, int worker );
+static void offsetIterationCounts( void *data, int task, int worker );
+static void renderTile( void *data, int tile, int worker );
+static bool computeTileSamples( FractalRenderer *renderer, int startLine, int endLine, 
+                                int startColumn, int endColumn, int step, int previousStep,
+                                FractalCounters *counters );
+static void colorTile( FractalRenderer *renderer, int startLine, int endLine, 
+                       int startColumn, int endColumn, int step );
+static void uploadTile( FractalRenderer *renderer, int tile );
+static void markFilledPixels( const bool *filled, int count, Color *colors );
+static void refineTile( void *data, int tile, int worker );
+static bool isEdgePixel( const FractalRenderer *renderer, int line, int column );
+static bool isRefinementKept( const FractalRenderer *renderer );
+static void supersamplePixels( FractalRenderer *renderer, RefinedTile *refinedTile, 
+                               int line, const int *columns, int count );
+static void colorRefinedTile( FractalRenderer *renderer, const RefinedTile *refinedTile );
+static void colorRefinedPixels( FractalRenderer *renderer, const RefinedTile *refinedTile, 
+                                int start, int count );
+static uint32_t hashSample( uint32_t x );
+
+/**
+ * @brief Creates a dinamically allocated FractalRenderer for width x
+ * height images. Must be called after the window is created.
+ */
+FractalRenderer* createFractalRenderer( int width, int height, int threadCount ) {
+
+    FractalRenderer *renderer = (FractalRenderer*) malloc( sizeof( FractalRenderer ) );
+
+    renderer->width = width;
+    renderer->height = height;
+    renderer->tileLines = ( height + TILE_SIZE - 1 ) / TILE_SIZE;
+    renderer->tileColumns = ( width + TILE_SIZE - 1 ) / TILE_SIZE;
+    renderer->tileCount = renderer->tileLines * renderer->tileColumns;
+
+    renderer->pool = createThreadPool( threadCount );
+    renderer->kernel = getEscapeKernel();
+    memset( &renderer->params, 0, sizeof( FractalParams ) );
+    renderer->palette = (FractalPalette) { 0 };
+    renderer->orbit = (ReferenceOrbit) { 0 };
+    renderer->render = 0;
+    renderer->view = 0;
+    renderer->pass = 0;
+    renderer->started = false;
+    renderer->histogramReady = false;
+    renderer->refining = false;
+    renderer->refined = false;
+
+    renderer->iterations = (int*) calloc( width * height, sizeof( int ) );
+    renderer->smooth = (double*) calloc( width * height, sizeof( double ) );
+    renderer->filled = (bool*) calloc( width * height, sizeof( bool ) );
+    renderer->tileView = (int*) calloc( renderer->tileCount, sizeof( int ) );
+    renderer->tilePass = (int*) calloc( renderer->tileCount, sizeof( int ) );
+    renderer->pixels = (Color*) calloc( width * height, sizeof( Color ) );
+    renderer->tileRender = (int*) calloc( renderer->tileCount, sizeof( int ) );
+    renderer->cancelled = 0;
+    renderer->counters = (FractalCounters) { 0 };
+    renderer->refinedPixels = 0;
+    renderer->refinedTiles = (RefinedTile*) calloc( renderer->tileCount, sizeof( RefinedTile ) );
+
+    renderer->histograms = NULL;
+    renderer->cumulative = NULL;
+    renderer->histogramCapacity = 0;
+
+    renderer->tileUploaded = (bool*) calloc( renderer->tileCount, sizeof( bool ) );
+    renderer->uploadedTiles = 0;
+    renderer->tilePixels = (Color*) malloc( sizeof( Color ) * TILE_SIZE * TILE_SIZE );
+    renderer->recolorTime = 0;
+
+    Image image = GenImageColor( width, height, BLACK );
+    renderer->texture = LoadTextureFromImage( image );
+    UnloadImage( image );
+
+    return renderer;
+
+}
+
+/**
+ * @brief Destroys a FractalRenderer, its thread pool and its texture.
+ */
+void destroyFractalRenderer( FractalRenderer *renderer ) {
+
+    __atomic_store_n( &renderer->cancelled, 1, __ATOMIC_RELAXED );
+    destroyThreadPool( renderer->pool );
+    UnloadTexture( renderer->texture );
+
+    freeFractalPalette( &renderer->palette );
+    freeReferenceOrbit( &renderer->orbit );
+    free( renderer->iterations );
+    free( renderer->smooth );
+    free( renderer->filled );
+    free( renderer->tileView );
+    free( renderer->tilePass );
+    free( renderer->pixels );
+    free( renderer->tileRender );
+    for ( int i = 0; i < renderer->tileCount; i++ ) {
+        free( renderer->refinedTiles[i].pixels );
+        free( renderer->refinedTiles[i].iterations );
+        free( renderer->refinedTiles[i].smooth );
+    }
+    free( renderer->refinedTiles );
+    free( renderer->histograms );
+    free( renderer->cumulative );
+    free( renderer->tileUploaded );
+    free( renderer->tilePixels );
+    free( renderer );
+
+}
+
+/**
+ * @brief Starts rendering the fractal if params change the image of the
+ * last render, canceling the tiles of the previous one that were not
+ * computed yet. Returns the changes, as FractalChange flags. A new view
+ * starts from the coarsest pass; new colors keep the current one.
+ */
+int renderFractal( FractalRenderer *renderer, const FractalParams *params ) {
+
+    int changes = renderer->started ? getFractalChanges( &renderer->params, params ) :
+                                      FRACTAL_VIEW_CHANGED | FRACTAL_COLORS_CHANGED;
+
+    if ( changes == FRACTAL_UNCHANGED ) {
+        return changes;
+    }
+
+    // every escape time is known, so the new colors take a moment
+    bool recolor = changes == FRACTAL_COLORS_CHANGED && isFractalRenderFinished( renderer );
+    double startTime = GetTime();
+
+    // the tiles being computed stop at their next line
+    __atomic_store_n( &renderer->cancelled, 1, __ATOMIC_RELAXED );
+    waitThreadPoolBatch( renderer->pool );
+    __atomic_store_n( &renderer->cancelled, 0, __ATOMIC_RELAXED );
+
+    renderer->params = *params;
+    renderer->started = true;
+    if ( changes & FRACTAL_VIEW_CHANGED ) {
+        renderer->view++;
+        renderer->pass = 0;
+        renderer->counters = (FractalCounters) { 0 };
+        if ( params->perturbation ) {
+            computeReferenceOrbit( &renderer->orbit, &params->centerX, &params->centerY, 
+                                   params->maxIterations );
+        }
+    }
+    updateFractalPalette( &renderer->palette, params );
+
+    // the refined edges are colored again from their samples, so the
+    // image does not need to be refined again
+    renderer->refined = recolor && params->antialiasing && isRefinementKept( renderer );
+    startRenderPass( renderer );
+
+    // the refinement of the edges is not waited for
+    if ( recolor ) {
+        while ( !renderer->refining && !isFractalRenderFinished( renderer ) ) {
+            waitThreadPoolBatch( renderer->pool );
+            updateFractalTexture( renderer );
+        }
+        renderer->recolorTime = GetTime() - startTime;
+    }
+
+    return changes;
+
+}
+
+/**
+ * @brief Uploads the tiles finished since the last call to the texture
+ * and, if the current pass is complete, starts the next one.
+ */
+void updateFractalTexture( FractalRenderer *renderer ) {
+
+    if ( renderer->uploadedTiles == renderer->tileCount ) {
+        return;
+    }
+
+    // the tiles are colored once all of them are computed
+    if ( renderer->params.histogram && !renderer->histogramReady ) {
+        if ( isThreadPoolBatchFinished( renderer->pool ) ) {
+            updateHistogramPalette( renderer );
+            renderer->histogramReady = true;
+            startThreadPoolBatch( renderer->pool, renderer->tileCount, renderTile, renderer );
+        }
+        return;
+    }
+
+    int finished[renderer->tileCount];
+    int finishedCount = 0;
+
+    for ( int i = 0; i < renderer->tileCount; i++ ) {
+        if ( !renderer->tileUploaded[i] &&
+             __atomic_load_n( &renderer->tileRender[i], __ATOMIC_ACQUIRE ) == renderer->render ) {
+            finished[finishedCount++] = i;
+        }
+    }
+
+    if ( finishedCount == renderer->tileCount ) {
+        // the whole image finished between two frames
+        UpdateTexture( renderer->texture, renderer->pixels );
+    } else {
+        for ( int i = 0; i < finishedCount; i++ ) {
+            uploadTile( renderer, finished[i] );
+        }
+    }
+
+    for ( int i = 0; i < finishedCount; i++ ) {
+        renderer->tileUploaded[finished[i]] = true;
+    }
+    renderer->uploadedTiles += finishedCount;
+
+    if ( renderer->uploadedTiles == renderer->tileCount && renderer->pass < PASS_COUNT - 1 ) {
+        waitThreadPoolBatch( renderer->pool );
+        renderer->pass++;
+        startRenderPass( renderer );
+    } else if ( renderer->uploadedTiles == renderer->tileCount && 
+                renderer->params.antialiasing && !renderer->refining && !renderer->refined ) {
+        waitThreadPoolBatch( renderer->pool );
+        startRefinement( renderer );
+    }
+
+}
+
+/**
+ * @brief Returns the fraction (0 to 1) of the pixels of the current
+ * render that are iterated and uploaded to the texture.
+ */
+double getFractalRenderProgress( const FractalRenderer *renderer ) {
+
+    if ( renderer->refining ) {
+        return renderer->uploadedTiles / (double) renderer->tileCount;
+    }
+
+    // each pass iterates 1 / step^2 of the pixels, minus the previous ones
+    int step = getFractalRenderStep( renderer );
+    double done = renderer->pass == 0 ? 0 : 1 / ( 4.0 * step * step );
+    double current = 1 / (double) ( step * step ) - done;
+
+    return done + current * renderer->uploadedTiles / (double) renderer->tileCount;
+
+}
+
+/**
+ * @brief Returns the size of the blocks of pixels drawn with the same
+ * color by the current pass: COARSEST_STEP in the first one, 1 in the
+ * last.
+ */
+int getFractalRenderStep( const FractalRenderer *renderer ) {
+    return COARSEST_STEP >> renderer->pass;
+}
+
+/**
+ * @brief Returns true when the texture holds the whole current render,
+ * at full resolution and, with anti-aliasing, refined.
+ */
+bool isFractalRenderFinished( const FractalRenderer *renderer ) {
+    return renderer->pass == PASS_COUNT - 1 && renderer->uploadedTiles == renderer->tileCount &&
+           ( renderer->refining || renderer->refined || !renderer->params.antialiasing );
+}
+
+/**
+ * @brief Returns how many pixels of the current view skipped the
+ * iteration so far.
+ */
+FractalCounters getFractalCounters( const FractalRenderer *renderer ) {
+    return (FractalCounters) {
+        .iterated = __atomic_load_n( &renderer->counters.iterated, __ATOMIC_RELAXED ),
+        .interior = __atomic_load_n( &renderer->counters.interior, __ATOMIC_RELAXED ),
+        .periodic = __atomic_load_n( &renderer->counters.periodic, __ATOMIC_RELAXED ),
+        .filled = __atomic_load_n( &renderer->counters.filled, __ATOMIC_RELAXED )
+    };
+}
+
+/**
+ * @brief Returns how many pixels the anti-aliasing supersampled so far.
+ */
+int getFractalRefinedPixels( const FractalRenderer *renderer ) {
+    return __atomic_load_n( &renderer->refinedPixels, __ATOMIC_RELAXED );
+}
+
+/**
+ * @brief Draws the texture with the fractal.
+ */
+void drawFractal( const FractalRenderer *renderer ) {
+    DrawTexture( renderer->texture, 0, 0, WHITE );
+}
+
+/**
+ * @brief Starts the tasks of the current pass.
+ */
+static void startRenderPass( FractalRenderer *renderer ) {
+    renderer->render++;
+    renderer->histogramReady = false;
+    renderer->refining = false;
+    memset( renderer->tileUploaded, 0, sizeof( bool ) * renderer->tileCount );
+    renderer->uploadedTiles = 0;
+    startThreadPoolBatch( renderer->pool, renderer->tileCount, renderTile, renderer );
+}
+
+/**
+ * @brief Starts the tasks of the refinement of the edges, once the last
+ * pass is complete.
+ */
+static void startRefinement( FractalRenderer *renderer ) {
+    renderer->render++;
+    renderer->refining = true;
+    renderer->refinedPixels = 0;
+    memset( renderer->tileUploaded, 0, sizeof( bool ) * renderer->tileCount );
+    renderer->uploadedTiles = 0;
+    startThreadPoolBatch( renderer->pool, renderer->tileCount, refineTile, renderer );
+}
+
+static void renderTile( void *data, int tile, int worker ) {
+
+    FractalRenderer *renderer = (FractalRenderer*) data;
+    const FractalParams *params = &renderer->params;
+    int width = renderer->width;
+    int height = renderer->height;
+    int pass = renderer->pass;
+    int step = COARSEST_STEP >> pass;
+
+    int startLine = ( tile / renderer->tileColumns ) * TILE_SIZE;
+    int startColumn = ( tile % renderer->tileColumns ) * TILE_SIZE;
+    int endLine = startLine + TILE_SIZE < height ? startLine + TILE_SIZE : height;
+    int endColumn = startColumn + TILE_SIZE < width ? startColumn + TILE_SIZE : width;
+
+    // the escape times are computed only if the tile does not have the
+    // ones of this pass of the view yet; the samples of the previous
+    // passes of the same view are reused
+    bool sameView = renderer->tileView[tile] == renderer->view;
+    if ( !sameView || renderer->tilePass[tile] < pass ) {
+        FractalCounters counters = { 0 };
+        if ( params->subdivision && params->mandelbrot && step == 1 ) {
+            if ( __atomic_load_n( &renderer->cancelled, __ATOMIC_RELAXED ) ) {
+                return;
+            }
+            computeFractalRectangle( params, renderer->kernel, &renderer->orbit, 
+                                     startLine, endLine, startColumn, endColumn, width, height,
+                                     renderer->iterations, renderer->smooth, renderer->filled,
+                                     &counters );
+        } else {
+            int previousStep = sameView ? COARSEST_STEP >> renderer->tilePass[tile] : 0;
+            if ( !computeTileSamples( renderer, startLine, endLine, startColumn, endColumn, 
+                                      step, previousStep, &counters ) ) {
+                return;
+            }
+        }
+        renderer->tileView[tile] = renderer->view;
+        renderer->tilePass[tile] = pass;
+        __atomic_add_fetch( &renderer->counters.iterated, counters.iterated, __ATOMIC_RELAXED );
+        __atomic_add_fetch( &renderer->counters.interior, counters.interior, __ATOMIC_RELAXED );
+        __atomic_add_fetch( &renderer->counters.periodic, counters.periodic, __ATOMIC_RELAXED );
+        __atomic_add_fetch( &renderer->counters.filled, counters.filled, __ATOMIC_RELAXED );
+    }
+
+    if ( params->histogram && !renderer->histogramReady ) {
+        return;
+    }
+
+    colorTile( renderer, startLine, endLine, startColumn, endColumn, step );
+
+    // the edges refined before take the colors of their kept samples
+    RefinedTile *refinedTile = &renderer->refinedTiles[tile];
+    if ( params->antialiasing && step == 1 && refinedTile->view == renderer->view ) {
+        colorRefinedTile( renderer, refinedTile );
+    }
+
+    __atomic_store_n( &renderer->tileRender[tile], renderer->render, __ATOMIC_RELEASE );
+
+}
+
+/**
+ * @brief Fills the palette with the histogram of the iteration counts of
+ * the pixels of the current pass, in three parallel steps: each worker
+ * counts the iterations of some lines in its own histogram; each block
+ * of iteration counts is summed over the workers and accumulated; and,
+ * after the sums of the previous blocks are accumulated here, they are
+ * added to each block.
+ */
+static void updateHistogramPalette( FractalRenderer *renderer ) {
+
+    // based on https://en.wikipedia.org/wiki/Prefix_sum#Parallel_algorithms
+    int bins = renderer->params.maxIterations + 1;
+    int threadCount = renderer->pool->threadCount;
+
+    if ( bins > renderer->histogramCapacity ) {
+        free( renderer->histograms );
+        free( renderer->cumulative );
+        renderer->histograms = (int*) malloc( sizeof( int ) * bins * threadCount );
+        renderer->cumulative = (int*) malloc( sizeof( int ) * bins );
+        renderer->histogramCapacity = bins;
+    }
+    memset( renderer->histograms, 0, sizeof( int ) * bins * threadCount );
+
+    runThreadPoolBatch( renderer->pool, HISTOGRAM_TASKS, countIterations, renderer );
+    runThreadPoolBatch( renderer->pool, HISTOGRAM_TASKS, sumIterationCounts, renderer );
+
+    int offset = 0;
+    for ( int i = 0; i < HISTOGRAM_TASKS; i++ ) {
+        int sum = renderer->blockSums[i];
+        renderer->blockSums[i] = offset;
+        offset += sum;
+    }
+
+    runThreadPoolBatch( renderer->pool, HISTOGRAM_TASKS, offsetIterationCounts, renderer );
+
+    updateFractalHistogramPalette( &renderer->palette, &renderer->params, renderer->cumulative );
+
+}
+
+/**
+ * @brief Counts the iterations of the escaped pixels of the current pass
+ * in a band of lines of the image.
+ */
+static void countIterations( void *data, int task, int worker ) {
+
+    FractalRenderer *renderer = (FractalRenderer*) data;
+    int width = renderer->width;
+    int step = COARSEST_STEP >> renderer->pass;
+    int maxIterations = renderer->params.maxIterations;
+    int *histogram = &renderer->histograms[worker*( maxIterations + 1 )];
+
+    // the bands start at lines of the pass
+    int lines = ( renderer->height + step - 1 ) / step;
+    int startLine = (int) ( (long long) lines * task / HISTOGRAM_TASKS ) * step;
+    int endLine = (int) ( (long long) lines * ( task + 1 ) / HISTOGRAM_TASKS ) * step;
+    endLine = endLine < renderer->height ? endLine : renderer->height;
+
+    for ( int i = startLine; i < endLine; i += step ) {
+        const int *iterations = &renderer->iterations[i*width];
+        for ( int j = 0; j < width; j += step ) {
+            if ( iterations[j] < maxIterations ) {
+                histogram[iterations[j]]++;
+            }
+        }
+    }
+
+}
+
+/**
+ * @brief Sums the histograms of the workers in a block of iteration
+ * counts, storing the exclusive prefix sum inside the block and the
+ * total of the block.
+ */
+static void sumIterationCounts( void *data, int task, int worker ) {
+
+    FractalRenderer *renderer = (FractalRenderer*) data;
+    int bins = renderer->params.maxIterations + 1;
+    int threadCount = renderer->pool->threadCount;
+    int start = (int) ( (long long) bins * task / HISTOGRAM_TASKS );
+    int end = (int) ( (long long) bins * ( task + 1 ) / HISTOGRAM_TASKS );
+    int sum = 0;
+
+    for ( int k = start; k < end; k++ ) {
+        int count = 0;
+        for ( int w = 0; w < threadCount; w++ ) {
+            count += renderer->histograms[w*bins+k];
+        }
+        renderer->cumulative[k] = sum;
+        sum += count;
+    }
+
+    renderer->blockSums[task] = sum;
+
+}
+
+/**
+ * @brief Adds the sum of the previous blocks to a block of iteration
+ * counts.
+ */
+static void offsetIterationCounts( void *data, int task, int worker ) {
+
+    FractalRenderer *renderer = (FractalRenderer*) data;
+    int bins = renderer->params.maxIterations + 1;
+    int start = (int) ( (long long) bins * task / HISTOGRAM_TASKS );
+    int end = (int) ( (long long) bins * ( task + 1 ) / HISTOGRAM_TASKS );
+    int offset = renderer->blockSums[task];
+
+    for ( int k = start; k < end; k++ ) {
+        renderer->cumulative[k] += offset;
+    }
+
+}
+
+/**
+ * @brief Iterates the pixels of a tile whose line and column are
+ * multiples of step, skipping the ones that are also multiples of
+ * previousStep (already computed; 0 if none is). Returns false if the
+ * render was canceled.
+ */
+static bool computeTileSamples( FractalRenderer *renderer, int startLine, int endLine, 
+                                int startColumn, int endColumn, int step, int previousStep,
+                                FractalCounters *counters ) {
+
+    int width = renderer->width;
+    int lines[TILE_SIZE];
+    int columns[TILE_SIZE];
+    int iterations[TILE_SIZE];
+    double smooth[TILE_SIZE];
+
+    for ( int i = startLine; i < endLine; i += step ) {
+
+        if ( __atomic_load_n( &renderer->cancelled, __ATOMIC_RELAXED ) ) {
+            return false;
+        }
+
+        bool previousLine = previousStep != 0 && i % previousStep == 0;
+        int count = 0;
+        for ( int j = startColumn; j < endColumn; j += step ) {
+            if ( !previousLine || j % previousStep != 0 ) {
+                lines[count] = i;
+                columns[count++] = j;
+            }
+        }
+
+        computeFractalPoints( &renderer->params, renderer->kernel, &renderer->orbit, 
+                              lines, columns, count, width, renderer->height, 
+                              iterations, smooth, counters );
+
+        for ( int k = 0; k < count; k++ ) {
+            int index = i * width + columns[k];
+            renderer->iterations[index] = iterations[k];
+            renderer->smooth[index] = smooth[k];
+            renderer->filled[index] = false;
+        }
+
+    }
+
+    return true;
+
+}
+
+/**
+ * @brief Colors the pixels of a tile: each step x step block takes the
+ * color of the pixel at its top left corner.
+ */
+static void colorTile( FractalRenderer *renderer, int startLine, int endLine, 
+                       int startColumn, int endColumn, int step ) {
+
+    const FractalParams *params = &renderer->params;
+    int width = renderer->width;
+    int iterations[TILE_SIZE];
+    double smooth[TILE_SIZE];
+    bool filled[TILE_SIZE];
+    Color colors[TILE_SIZE];
+
+    for ( int i = startLine; i < endLine; i += step ) {
+
+        const int *lineIterations = &renderer->iterations[i*width+startColumn];
+        const double *lineSmooth = &renderer->smooth[i*width+startColumn];
+        const bool *lineFilled = &renderer->filled[i*width+startColumn];
+        Color *lineColors = &renderer->pixels[i*width+startColumn];
+        int count = endColumn - startColumn;
+
+        if ( step > 1 ) {
+            count = 0;
+            for ( int j = startColumn; j < endColumn; j += step ) {
+                iterations[count] = renderer->iterations[i*width+j];
+                smooth[count] = renderer->smooth[i*width+j];
+                filled[count++] = renderer->filled[i*width+j];
+            }
+            lineIterations = iterations;
+            lineSmooth = smooth;
+            lineFilled = filled;
+            lineColors = colors;
+        }
+
+        colorFractalRow( params, &renderer->palette, lineIterations, lineSmooth, count, lineColors );
+        if ( params->showSubdivision ) {
+            markFilledPixels( lineFilled, count, lineColors );
+        }
+
+        if ( step > 1 ) {
+            int blockEnd = i + step < endLine ? i + step : endLine;
+            for ( int bi = i; bi < blockEnd; bi++ ) {
+                for ( int j = startColumn; j < endColumn; j++ ) {
+                    renderer->pixels[bi*width+j] = colors[( j - startColumn ) / step];
+                }
+            }
+        }
+
+    }
+
+}
+
+/**
+ * @brief Tints the pixels filled by subdivision, so the filled rectangles
+ * show up between the iterated borders.
+ */
+static void markFilledPixels( const bool *filled, int count, Color *colors ) {
+    for ( int k = 0; k < count; k++ ) {
+        if ( filled[k] ) {
+            colors[k] = (Color) {
+                .r = ( colors[k].r + 255 ) / 2,
+                .g = colors[k].g / 2,
+                .b = ( colors[k].b + 255 ) / 2,
+                .a = 255
+            };
+        }
+    }
+}
+
+/**
+ * @brief Supersamples the pixels of a tile at the edges between
+ * iteration counts, or colors them again if the tile kept their samples.
+ * The escape times of the whole image are complete, so the neighbors in
+ * other tiles can be read.
+ */
+static void refineTile( void *data, int tile, int worker ) {
+
+    FractalRenderer *renderer = (FractalRenderer*) data;
+    RefinedTile *refinedTile = &renderer->refinedTiles[tile];
+
+    if ( refinedTile->view == renderer->view ) {
+        colorRefinedTile( renderer, refinedTile );
+        __atomic_add_fetch( &renderer->refinedPixels, refinedTile->count, __ATOMIC_RELAXED );
+        __atomic_store_n( &renderer->tileRender[tile], renderer->render, __ATOMIC_RELEASE );
+        return;
+    }
+
+    int startLine = ( tile / renderer->tileColumns ) * TILE_SIZE;
+    int startColumn = ( tile % renderer->tileColumns ) * TILE_SIZE;
+    int endLine = startLine + TILE_SIZE < renderer->height ? startLine + TILE_SIZE : renderer->height;
+    int endColumn = startColumn + TILE_SIZE < renderer->width ? startColumn + TILE_SIZE : renderer->width;
+    int columns[SUPERSAMPLED_PIXELS];
+    int refined = 0;
+
+    // the samples are kept only if the whole tile is refined
+    refinedTile->view = 0;
+    refinedTile->count = 0;
+
+    for ( int i = startLine; i < endLine; i++ ) {
+
+        if ( __atomic_load_n( &renderer->cancelled, __ATOMIC_RELAXED ) ) {
+            return;
+        }
+
+        int count = 0;
+        for ( int j = startColumn; j < endColumn; j++ ) {
+            if ( isEdgePixel( renderer, i, j ) ) {
+                columns[count++] = j;
+            }
+            if ( count == SUPERSAMPLED_PIXELS || ( j == endColumn - 1 && count > 0 ) ) {
+                supersamplePixels( renderer, refinedTile, i, columns, count );
+                refined += count;
+                count = 0;
+            }
+        }
+
+    }
+
+    refinedTile->view = renderer->view;
+    __atomic_add_fetch( &renderer->refinedPixels, refined, __ATOMIC_RELAXED );
+    __atomic_store_n( &renderer->tileRender[tile], renderer->render, __ATOMIC_RELEASE );
+
+}
+
+/**
+ * @brief Returns true if every tile kept the samples of the refinement
+ * of the current view.
+ */
+static bool isRefinementKept( const FractalRenderer *renderer ) {
+    for ( int i = 0; i < renderer->tileCount; i++ ) {
+        if ( renderer->refinedTiles[i].view != renderer->view ) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Returns true if the iteration count of the pixel differs from
+ * the one of some of its four neighbors.
+ */
+static bool isEdgePixel( const FractalRenderer *renderer, int line, int column ) {
+
+    int width = renderer->width;
+    const int *iterations = &renderer->iterations[line*width+column];
+    int count = *iterations;
+
+    return ( column > 0 && iterations[-1] != count ) ||
+           ( column < width - 1 && iterations[1] != count ) ||
+           ( line > 0 && iterations[-width] != count ) ||
+           ( line < renderer->height - 1 && iterations[width] != count );
+
+}
+
+/**
+ * @brief Supersamples count pixels of a line on a jittered grid over
+ * each one, computing the samples together and keeping them in the
+ * refined tile, and colors the pixels.
+ */
+static void supersamplePixels( FractalRenderer *renderer, RefinedTile *refinedTile, 
+                               int line, const int *columns, int count ) {
+
+    const FractalParams *params = &renderer->params;
+    int width = renderer->width;
+    int height = renderer->height;
+    int gridSamples = SUPERSAMPLING_GRID * SUPERSAMPLING_GRID;
+    double xs[MAX_ROW_LENGTH];
+    double ys[MAX_ROW_LENGTH];
+    FractalCounters counters = { 0 };
+    int samples = 0;
+
+    if ( count == 0 ) {
+        return;
+    }
+
+    if ( refinedTile->count + count > refinedTile->capacity ) {
+        int capacity = refinedTile->capacity * 2;
+        capacity = capacity > refinedTile->count + count ? capacity : refinedTile->count + count;
+        refinedTile->pixels = (int*) realloc( refinedTile->pixels, sizeof( int ) * capacity );
+        refinedTile->iterations = (int*) realloc( refinedTile->iterations, 
+                                                  sizeof( int ) * capacity * gridSamples );
+        refinedTile->smooth = (double*) realloc( refinedTile->smooth, 
+                                                 sizeof( double ) * capacity * gridSamples );
+        refinedTile->capacity = capacity;
+    }
+
+    // each sample is at a random point of its cell of the pixel; the
+    // point comes from a hash of the sample, so it is the same every time
+    for ( int k = 0; k < count; k++ ) {
+        refinedTile->pixels[refinedTile->count+k] = line * width + columns[k];
+        for ( int a = 0; a < SUPERSAMPLING_GRID; a++ ) {
+            for ( int b = 0; b < SUPERSAMPLING_GRID; b++ ) {
+                uint32_t hash = hashSample( (uint32_t) ( line * width + columns[k] ) * 
+                                            gridSamples + a * SUPERSAMPLING_GRID + b );
+                double dx = ( b + ( hash & 0xFFFF ) / 65536.0 ) / SUPERSAMPLING_GRID - 0.5;
+                double dy = ( a + ( hash >> 16 ) / 65536.0 ) / SUPERSAMPLING_GRID - 0.5;
+                xs[samples] = Lerp( params->minX, params->maxX, ( columns[k] + dx ) / width );
+                ys[samples] = Lerp( params->minY, params->maxY, ( line + dy ) / height );
+                samples++;
+            }
+        }
+    }
+
+    int start = refinedTile->count;
+    computeFractalSamples( params, renderer->kernel, &renderer->orbit, xs, ys, samples,
+                           &refinedTile->iterations[start*gridSamples], 
+                           &refinedTile->smooth[start*gridSamples], &counters );
+    refinedTile->count += count;
+
+    colorRefinedPixels( renderer, refinedTile, start, count );
+
+}
+
+/**
+ * @brief Colors all the refined pixels of a tile from their kept
+ * samples.
+ */
+static void colorRefinedTile( FractalRenderer *renderer, const RefinedTile *refinedTile ) {
+    for ( int start = 0; start < refinedTile->count; start += SUPERSAMPLED_PIXELS ) {
+        int count = refinedTile->count - start;
+        colorRefinedPixels( renderer, refinedTile, start, 
+                            count < SUPERSAMPLED_PIXELS ? count : SUPERSAMPLED_PIXELS );
+    }
+}
+
+/**
+ * @brief Colors count refined pixels of a tile, from the start-th one,
+ * with the mean color of their samples.
+ */
+static void colorRefinedPixels( FractalRenderer *renderer, const RefinedTile *refinedTile, 
+                                int start, int count ) {
+
+    const FractalParams *params = &renderer->params;
+    int gridSamples = SUPERSAMPLING_GRID * SUPERSAMPLING_GRID;
+    Color colors[MAX_ROW_LENGTH];
+
+    colorFractalRow( params, &renderer->palette, &refinedTile->iterations[start*gridSamples],
+                     &refinedTile->smooth[start*gridSamples], count * gridSamples, colors );
+
+    for ( int k = 0; k < count; k++ ) {
+        int r = 0;
+        int g = 0;
+        int b = 0;
+        for ( int s = k * gridSamples; s < ( k + 1 ) * gridSamples; s++ ) {
+            r += colors[s].r;
+            g += colors[s].g;
+            b += colors[s].b;
+        }
+        int index = refinedTile->pixels[start+k];
+        renderer->pixels[index] = (Color) {
+            .r = ( r + gridSamples / 2 ) / gridSamples,
+            .g = ( g + gridSamples / 2 ) / gridSamples,
+            .b = ( b + gridSamples / 2 ) / gridSamples,
+            .a = 255
+        };
+        if ( params->showSubdivision ) {
+            markFilledPixels( &renderer->filled[index], 1, &renderer->pixels[index] );
+        }
+    }
+
+}
+
+/**
+ * @brief Mixes the bits of x, so consecutive values give unrelated ones.
+ */
+static uint32_t hashSample( uint32_t x ) {
+    // based on https://nullprogram.com/blog/2018/07/31/
+    x ^= x >> 16;
+    x *= 0x7feb352d;
+    x ^= x >> 15;
+    x *= 0x846ca68b;
+    x ^= x >> 16;
+    return x;
+}
+
+/**
+ * @brief Copies a finished tile to a contiguous buffer and uploads it to
+ * its region of the texture.
+ */
+static void uploadTile( FractalRenderer *renderer, int tile ) {
+
+    int width = renderer->width;
+    int startLine = ( tile / renderer->tileColumns ) * TILE_SIZE;
+    int startColumn = ( tile % renderer->tileColumns ) * TILE_SIZE;
+    int tileWidth = startColumn + TILE_SIZE < width ? TILE_SIZE : width - startColumn;
+    int tileHeight = startLine + TILE_SIZE < renderer->height ? TILE_SIZE : renderer->height - startLine;
+
+    for ( int i = 0; i < tileHeight; i++ ) {
+        memcpy( &renderer->tilePixels[i*tileWidth],
+                &renderer->pixels[(startLine+i)*width+startColumn],
+                sizeof( Color ) * tileWidth );
+    }
+
+    UpdateTextureRec( renderer->texture,
+                      (Rectangle) { startColumn, startLine, tileWidth, tileHeight },
+                      renderer->tilePixels );
+
+}
@@ -0,0 +1,143 @@
+/**
+ * @file Perturbation.c
+ * @author Prof. Dr. David Buzatto
+ * @brief Reference orbit and perturbation iteration.
+ *
+ * @copyright Copyright (c) 2024
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include "Perturbation.h"
+#include "BigFloat.h"
+
+/**
+ * @brief Computes the orbit of c = cx + cy*i, up to maxIterations or
+ * until it escapes, rounding each point to doubles.
+ */
+void computeReferenceOrbit( ReferenceOrbit *orbit, const BigFloat *cx, const BigFloat *cy, int maxIterations ) {
+
+    if ( maxIterations + 1 > orbit->capacity ) {
+        free( orbit->x );
+        free( orbit->y );
+        orbit->capacity = maxIterations + 1;
+        orbit->x = (double*) malloc( sizeof( double ) * orbit->capacity );
+        orbit->y = (double*) malloc( sizeof( double ) * orbit->capacity );
+    }
+
+    int limbs = cx->limbs > cy->limbs ? cx->limbs : cy->limbs;
+    BigFloat x = bigFloatFromDouble( 0, limbs );
+    BigFloat y = bigFloatFromDouble( 0, limbs );
+    BigFloat xx;
+    BigFloat yy;
+    BigFloat xy;
+    BigFloat t;
+
+    orbit->length = 0;
+
+    for ( int n = 0; n <= maxIterations; n++ ) {
+
+        double px = bigFloatToDouble( &x );
+        double py = bigFloatToDouble( &y );
+        orbit->x[n] = px;
+        orbit->y[n] = py;
+        orbit->length++;
+
+        // the pixels rebase once they reach the end of the orbit
+        if ( px * px + py * py > 4 ) {
+            break;
+        }
+
+        // z = z^2 + c
+        bigFloatMul( &xx, &x, &x );
+        bigFloatMul( &yy, &y, &y );
+        bigFloatMul( &xy, &x, &y );
+        bigFloatSub( &t, &xx, &yy );
+        bigFloatAdd( &x, &t, cx );
+        bigFloatAdd( &t, &xy, &xy );
+        bigFloatAdd( &y, &t, cy );
+
+    }
+
+}
+
+/**
+ * @brief Frees the points of the orbit.
+ */
+void freeReferenceOrbit( ReferenceOrbit *orbit ) {
+    free( orbit->x );
+    free( orbit->y );
+    orbit->x = NULL;
+    orbit->y = NULL;
+    orbit->length = 0;
+    orbit->capacity = 0;
+}
+
+/**
+ * @brief Iterates the count points c = C + dcx[k] + dcy[k]*i by
+ * perturbation of the reference orbit of C while |z|^2 <= bailout and up
+ * to maxIterations times, storing the iterations executed and the last z
+ * of each point. Returns how many times the points were rebased.
+ *
+ * A point whose z gets closer to zero than its difference to the
+ * reference can no longer be represented by that difference (this is
+ * what causes the "glitches" of perturbation): it is rebased, taking its
+ * z as the difference to the start of the orbit (Z = 0), and goes on
+ * following the orbit from there. The same is done when the reference
+ * orbit ends before the point escapes.
+ */
+int escapePerturbed( const ReferenceOrbit *orbit, const double *dcx, const double *dcy,
+                     int count, int maxIterations, double bailout,
+                     int *iterations, double *zx, double *zy ) {
+
+    const double *rx = orbit->x;
+    const double *ry = orbit->y;
+    int last = orbit->length - 1;
+    int rebases = 0;
+
+    for ( int k = 0; k < count; k++ ) {
+
+        double dx = 0;
+        double dy = 0;
+        double x = 0;
+        double y = 0;
+        int m = 0;
+        int iteration;
+
+        for ( iteration = 0; iteration < maxIterations; iteration++ ) {
+
+            x = rx[m] + dx;
+            y = ry[m] + dy;
+            double r2 = x * x + y * y;
+
+            if ( r2 > bailout ) {
+                break;
+            }
+
+            if ( r2 < dx * dx + dy * dy || m == last ) {
+                dx = x;
+                dy = y;
+                m = 0;
+                rebases++;
+            }
+
+            // d' = ( 2Z + d )d + dc
+            double tx = 2 * rx[m] + dx;
+            double ty = 2 * ry[m] + dy;
+            double ndx = tx * dx - ty * dy + dcx[k];
+            dy = tx * dy + ty * dx + dcy[k];
+            dx = ndx;
+            m++;
+
+        }
+
+        iterations[k] = iteration;
+        zx[k] = x;
+        zy[k] = y;
+
+    }
+
+    return rebases;
+
+}
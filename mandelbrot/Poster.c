@@ -0,0 +1,419 @@
+/**
+ * @file Poster.c
+ * @author Prof. Dr. David Buzatto
+ * @brief Poster implementation.
+ *
+ * @copyright Copyright (c) 2024
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+#include "Poster.h"
+#include "EscapeKernel.h"
+#include "Fractal.h"
+#include "ThreadPool.h"
+
+#include "raylib.h"
+
+// the largest stored deflate block
+#define MAX_BLOCK_SIZE 65535
+
+typedef struct PosterStrip {
+    const FractalParams *params;
+    const FractalPalette *palette;
+    EscapeKernel kernel;
+    int width;
+    int height;
+    int firstLine;
+    Color *pixels;
+} PosterStrip;
+
+typedef struct PosterWriter {
+    FILE *file;
+    bool png;
+    uint8_t *row;           // filter byte (png) and RGB of a line
+    int rowSize;
+    uint32_t crc;           // of the current png chunk
+    uint32_t adlerA;        // of the whole zlib stream
+    uint32_t adlerB;
+    int blockRemaining;     // bytes left in the current deflate block
+    int chunkRemaining;     // deflate data left in the current chunk
+} PosterWriter;
+
+static uint32_t crcTable[256];
+
+static void renderStripLine( void *data, int task, int worker );
+static bool beginPoster( PosterWriter *writer, const char *fileName, int width, int height );
+static void writeStrip( PosterWriter *writer, const Color *pixels, int width, int lines );
+static bool endPoster( PosterWriter *writer );
+static void writeBytes( PosterWriter *writer, const void *bytes, int count );
+static void writeDeflateBytes( PosterWriter *writer, const uint8_t *bytes, int count );
+static void beginChunk( PosterWriter *writer, const char *type, uint32_t length );
+static void endChunk( PosterWriter *writer );
+static void writeUint32( uint8_t *bytes, uint32_t value );
+static void initCrcTable( void );
+
+/**
+ * @brief Renders a width x height image of the fractal of params (except
+ * for perturbation and histogram coloring) to fileName (.png or .ppm)
+ * using threadCount threads. Returns false if the file could not be
+ * written.
+ */
+bool renderFractalPoster( const FractalParams *params, int width, int height,
+                          const char *fileName, int threadCount, PosterStats *stats ) {
+
+    PosterWriter writer;
+    if ( !beginPoster( &writer, fileName, width, height ) ) {
+        return false;
+    }
+
+    double startTime = getRenderSeconds();
+
+    FractalParams stripParams = *params;
+    stripParams.perturbation = false;
+    stripParams.subdivision = false;
+    stripParams.showSubdivision = false;
+    stripParams.histogram = false;
+
+    FractalPalette palette = { 0 };
+    updateFractalPalette( &palette, &stripParams );
+
+    ThreadPool *pool = createThreadPool( threadCount );
+
+    // while a strip is written the next one is computed in the other
+    PosterStrip strips[2];
+    for ( int i = 0; i < 2; i++ ) {
+        strips[i] = (PosterStrip) {
+            .params = &stripParams,
+            .palette = &palette,
+            .kernel = getEscapeKernel(),
+            .width = width,
+            .height = height,
+            .firstLine = 0,
+            .pixels = (Color*) malloc( sizeof( Color ) * width * POSTER_STRIP_LINES )
+        };
+    }
+
+    int stripCount = ( height + POSTER_STRIP_LINES - 1 ) / POSTER_STRIP_LINES;
+    int current = 0;
+
+    startThreadPoolBatch( pool, height < POSTER_STRIP_LINES ? height : POSTER_STRIP_LINES,
+                          renderStripLine, &strips[current] );
+
+    for ( int i = 0; i < stripCount; i++ ) {
+
+        waitThreadPoolBatch( pool );
+
+        PosterStrip *strip = &strips[current];
+        int lines = height - strip->firstLine < POSTER_STRIP_LINES ?
+                    height - strip->firstLine : POSTER_STRIP_LINES;
+
+        if ( i + 1 < stripCount ) {
+            PosterStrip *next = &strips[1-current];
+            next->firstLine = strip->firstLine + POSTER_STRIP_LINES;
+            int nextLines = height - next->firstLine < POSTER_STRIP_LINES ?
+                            height - next->firstLine : POSTER_STRIP_LINES;
+            startThreadPoolBatch( pool, nextLines, renderStripLine, next );
+        }
+
+        writeStrip( &writer, strip->pixels, width, lines );
+        current = 1 - current;
+
+    }
+
+    destroyThreadPool( pool );
+    free( strips[0].pixels );
+    free( strips[1].pixels );
+    freeFractalPalette( &palette );
+
+    bool written = endPoster( &writer );
+
+    if ( stats != NULL ) {
+        stats->seconds = getRenderSeconds() - startTime;
+        stats->megapixelsPerSecond = (double) width * height / 1e6 / stats->seconds;
+    }
+
+    return written;
+
+}
+
+/**
+ * @brief Writes a width x height image to fileName (.png or .ppm).
+ * Returns false if the file could not be written.
+ */
+bool writeFractalImage( const Color *pixels, int width, int height, const char *fileName ) {
+
+    PosterWriter writer;
+    if ( !beginPoster( &writer, fileName, width, height ) ) {
+        return false;
+    }
+
+    writeStrip( &writer, pixels, width, height );
+    return endPoster( &writer );
+
+}
+
+/**
+ * @brief Returns the wall clock time in seconds, for the headless
+ * renderers, that have no window (and no GetTime).
+ */
+double getRenderSeconds( void ) {
+#ifdef _WIN32
+    // clock measures the elapsed time on Windows
+    return (double) clock() / CLOCKS_PER_SEC;
+#else
+    struct timespec now;
+    clock_gettime( CLOCK_MONOTONIC, &now );
+    return now.tv_sec + now.tv_nsec / 1e9;
+#endif
+}
+
+/**
+ * @brief Computes and colors one line of a strip.
+ */
+static void renderStripLine( void *data, int task, int worker ) {
+
+    PosterStrip *strip = (PosterStrip*) data;
+    int iterations[MAX_ROW_LENGTH];
+    double smooth[MAX_ROW_LENGTH];
+    FractalCounters counters = { 0 };
+    int line = strip->firstLine + task;
+
+    for ( int j = 0; j < strip->width; j += MAX_ROW_LENGTH ) {
+        int end = j + MAX_ROW_LENGTH < strip->width ? j + MAX_ROW_LENGTH : strip->width;
+        computeFractalRow( strip->params, strip->kernel, NULL, line, j, end,
+                           strip->width, strip->height, iterations, smooth, &counters );
+        colorFractalRow( strip->params, strip->palette, iterations, smooth, end - j,
+                         &strip->pixels[task*strip->width+j] );
+    }
+
+}
+
+/**
+ * @brief Opens the file and writes the header of the image.
+ */
+static bool beginPoster( PosterWriter *writer, const char *fileName, int width, int height ) {
+
+    const char *extension = strrchr( fileName, '.' );
+
+    writer->png = extension != NULL &&
+                  ( strcmp( extension, ".png" ) == 0 || strcmp( extension, ".PNG" ) == 0 );
+    writer->file = fopen( fileName, "wb" );
+    if ( writer->file == NULL ) {
+        return false;
+    }
+    setvbuf( writer->file, NULL, _IOFBF, 1 << 20 );
+
+    writer->rowSize = width * 3 + ( writer->png ? 1 : 0 );
+    writer->row = (uint8_t*) malloc( writer->rowSize );
+    writer->adlerA = 1;
+    writer->adlerB = 0;
+    writer->blockRemaining = 0;
+    writer->chunkRemaining = 0;
+
+    if ( !writer->png ) {
+        fprintf( writer->file, "P6\n%d %d\n255\n", width, height );
+        return true;
+    }
+
+    // based on https://www.w3.org/TR/png/
+    initCrcTable();
+    const uint8_t signature[] = { 137, 'P', 'N', 'G', '\r', '\n', 26, '\n' };
+    fwrite( signature, 1, sizeof( signature ), writer->file );
+
+    uint8_t header[13];
+    writeUint32( header, width );
+    writeUint32( header + 4, height );
+    header[8] = 8;      // bits per sample
+    header[9] = 2;      // RGB
+    header[10] = 0;     // deflate
+    header[11] = 0;     // adaptive filtering (every line uses none)
+    header[12] = 0;     // not interlaced
+    beginChunk( writer, "IHDR", sizeof( header ) );
+    writeBytes( writer, header, sizeof( header ) );
+    endChunk( writer );
+
+    // zlib header: deflate with a 32K window, no dictionary
+    const uint8_t zlibHeader[] = { 0x78, 0x01 };
+    beginChunk( writer, "IDAT", sizeof( zlibHeader ) );
+    writeBytes( writer, zlibHeader, sizeof( zlibHeader ) );
+    endChunk( writer );
+
+    return true;
+
+}
+
+/**
+ * @brief Writes lines lines of pixels; in a png, as one IDAT chunk of
+ * stored deflate blocks.
+ */
+static void writeStrip( PosterWriter *writer, const Color *pixels, int width, int lines ) {
+
+    if ( writer->png ) {
+        int64_t size = (int64_t) writer->rowSize * lines;
+        int64_t blocks = ( size + MAX_BLOCK_SIZE - 1 ) / MAX_BLOCK_SIZE;
+        beginChunk( writer, "IDAT", (uint32_t) ( size + 5 * blocks ) );
+        writer->chunkRemaining = (int) size;
+    }
+
+    for ( int i = 0; i < lines; i++ ) {
+
+        uint8_t *rgb = writer->row;
+        if ( writer->png ) {
+            *rgb++ = 0;     // no filter
+        }
+        for ( int j = 0; j < width; j++ ) {
+            Color color = pixels[i*width+j];
+            *rgb++ = color.r;
+            *rgb++ = color.g;
+            *rgb++ = color.b;
+        }
+
+        if ( writer->png ) {
+            writeDeflateBytes( writer, writer->row, writer->rowSize );
+        } else {
+            fwrite( writer->row, 1, writer->rowSize, writer->file );
+        }
+
+    }
+
+    if ( writer->png ) {
+        endChunk( writer );
+    }
+
+}
+
+/**
+ * @brief Ends the image and closes the file. Returns false if some write
+ * failed.
+ */
+static bool endPoster( PosterWriter *writer ) {
+
+    if ( writer->png ) {
+
+        // an empty final block and the checksum of the zlib stream
+        uint8_t end[9] = { 1, 0, 0, 0xFF, 0xFF };
+        writeUint32( end + 5, ( writer->adlerB << 16 ) | writer->adlerA );
+        beginChunk( writer, "IDAT", sizeof( end ) );
+        writeBytes( writer, end, sizeof( end ) );
+        endChunk( writer );
+
+        beginChunk( writer, "IEND", 0 );
+        endChunk( writer );
+
+    }
+
+    bool written = !ferror( writer->file );
+    written = fclose( writer->file ) == 0 && written;
+    free( writer->row );
+
+    return written;
+
+}
+
+/**
+ * @brief Writes bytes to the file, adding them to the CRC of the current
+ * png chunk.
+ */
+static void writeBytes( PosterWriter *writer, const void *bytes, int count ) {
+
+    if ( writer->png ) {
+        const uint8_t *b = (const uint8_t*) bytes;
+        uint32_t crc = writer->crc;
+        for ( int k = 0; k < count; k++ ) {
+            crc = crcTable[( crc ^ b[k] ) & 0xFF] ^ ( crc >> 8 );
+        }
+        writer->crc = crc;
+    }
+
+    fwrite( bytes, 1, count, writer->file );
+
+}
+
+/**
+ * @brief Writes image data to the zlib stream, starting a new stored
+ * block every MAX_BLOCK_SIZE bytes of the current chunk.
+ */
+static void writeDeflateBytes( PosterWriter *writer, const uint8_t *bytes, int count ) {
+
+    // the Adler-32 sums fit in 32 bits for 5552 bytes between modulos
+    for ( int start = 0; start < count; start += 5552 ) {
+        int end = start + 5552 < count ? start + 5552 : count;
+        for ( int k = start; k < end; k++ ) {
+            writer->adlerA += bytes[k];
+            writer->adlerB += writer->adlerA;
+        }
+        writer->adlerA %= 65521;
+        writer->adlerB %= 65521;
+    }
+
+    while ( count > 0 ) {
+
+        if ( writer->blockRemaining == 0 ) {
+            int length = writer->chunkRemaining < MAX_BLOCK_SIZE ?
+                         writer->chunkRemaining : MAX_BLOCK_SIZE;
+            uint8_t header[5] = {
+                0,      // not final, stored
+                length & 0xFF, ( length >> 8 ) & 0xFF,
+                ~length & 0xFF, ( ~length >> 8 ) & 0xFF
+            };
+            writeBytes( writer, header, sizeof( header ) );
+            writer->blockRemaining = length;
+        }
+
+        int part = count < writer->blockRemaining ? count : writer->blockRemaining;
+        writeBytes( writer, bytes, part );
+        bytes += part;
+        count -= part;
+        writer->blockRemaining -= part;
+        writer->chunkRemaining -= part;
+
+    }
+
+}
+
+/**
+ * @brief Writes the length and the type of a png chunk.
+ */
+static void beginChunk( PosterWriter *writer, const char *type, uint32_t length ) {
+    uint8_t bytes[4];
+    writeUint32( bytes, length );
+    fwrite( bytes, 1, 4, writer->file );
+    writer->crc = 0xFFFFFFFF;
+    writeBytes( writer, type, 4 );
+}
+
+/**
+ * @brief Writes the CRC of a png chunk.
+ */
+static void endChunk( PosterWriter *writer ) {
+    uint8_t bytes[4];
+    writeUint32( bytes, writer->crc ^ 0xFFFFFFFF );
+    fwrite( bytes, 1, 4, writer->file );
+}
+
+/**
+ * @brief Stores value in big endian order.
+ */
+static void writeUint32( uint8_t *bytes, uint32_t value ) {
+    bytes[0] = value >> 24;
+    bytes[1] = value >> 16;
+    bytes[2] = value >> 8;
+    bytes[3] = value;
+}
+
+static void initCrcTable( void ) {
+    for ( uint32_t n = 0; n < 256; n++ ) {
+        uint32_t c = n;
+        for ( int k = 0; k < 8; k++ ) {
+            c = c & 1 ? 0xEDB88320 ^ ( c >> 1 ) : c >> 1;
+        }
+        crcTable[n] = c;
+    }
+}
@@ -0,0 +1,234 @@
+/**
+ * @file ThreadPool.c
+ * @author Prof. Dr. David Buzatto
+ * @brief ThreadPool implementation.
+ *
+ * @copyright Copyright (c) 2024
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <pthread.h>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+#include "ThreadPool.h"
+
+typedef struct WorkerArgs {
+    ThreadPool *pool;
+    int worker;
+} WorkerArgs;
+
+static void *workerLoop( void *args );
+static bool takeTask( ThreadPool *pool, int worker, int *task );
+
+/**
+ * @brief Creates a dinamically allocated ThreadPool with threadCount
+ * worker threads.
+ */
+ThreadPool* createThreadPool( int threadCount ) {
+
+    ThreadPool *pool = (ThreadPool*) malloc( sizeof( ThreadPool ) );
+
+    pool->threadCount = threadCount < 1 ? 1 : threadCount;
+    pool->threads = (pthread_t*) malloc( sizeof( pthread_t ) * pool->threadCount );
+    pool->ranges = (TaskRange*) malloc( sizeof( TaskRange ) * pool->threadCount );
+    pool->function = NULL;
+    pool->data = NULL;
+    pool->pendingTasks = 0;
+    pool->batch = 0;
+    pool->stopping = false;
+
+    pthread_mutex_init( &pool->mutex, NULL );
+    pthread_cond_init( &pool->batchStarted, NULL );
+    pthread_cond_init( &pool->batchFinished, NULL );
+
+    for ( int i = 0; i < pool->threadCount; i++ ) {
+        pthread_mutex_init( &pool->ranges[i].mutex, NULL );
+        pool->ranges[i].head = 0;
+        pool->ranges[i].tail = 0;
+    }
+
+    for ( int i = 0; i < pool->threadCount; i++ ) {
+        WorkerArgs *args = (WorkerArgs*) malloc( sizeof( WorkerArgs ) );
+        args->pool = pool;
+        args->worker = i;
+        pthread_create( &pool->threads[i], NULL, workerLoop, args );
+    }
+
+    return pool;
+
+}
+
+/**
+ * @brief Destroys a ThreadPool, waiting for the current batch and joining
+ * all worker threads.
+ */
+void destroyThreadPool( ThreadPool *pool ) {
+
+    waitThreadPoolBatch( pool );
+
+    pthread_mutex_lock( &pool->mutex );
+    pool->stopping = true;
+    pthread_cond_broadcast( &pool->batchStarted );
+    pthread_mutex_unlock( &pool->mutex );
+
+    for ( int i = 0; i < pool->threadCount; i++ ) {
+        pthread_join( pool->threads[i], NULL );
+        pthread_mutex_destroy( &pool->ranges[i].mutex );
+    }
+
+    pthread_mutex_destroy( &pool->mutex );
+    pthread_cond_destroy( &pool->batchStarted );
+    pthread_cond_destroy( &pool->batchFinished );
+
+    free( pool->threads );
+    free( pool->ranges );
+    free( pool );
+
+}
+
+/**
+ * @brief Starts executing function( data, 0 ) ... function( data,
+ * taskCount - 1 ) and returns immediately. The previous batch must be
+ * finished.
+ */
+void startThreadPoolBatch( ThreadPool *pool, int taskCount, TaskFunction function, void *data ) {
+
+    pthread_mutex_lock( &pool->mutex );
+
+    pool->function = function;
+    pool->data = data;
+    pool->pendingTasks = taskCount;
+
+    // contiguous ranges keep neighbor tasks in the same thread
+    for ( int i = 0; i < pool->threadCount; i++ ) {
+        TaskRange *range = &pool->ranges[i];
+        pthread_mutex_lock( &range->mutex );
+        range->head = (int) ( (long long) taskCount * i / pool->threadCount );
+        range->tail = (int) ( (long long) taskCount * ( i + 1 ) / pool->threadCount );
+        pthread_mutex_unlock( &range->mutex );
+    }
+
+    pool->batch++;
+    pthread_cond_broadcast( &pool->batchStarted );
+    pthread_mutex_unlock( &pool->mutex );
+
+}
+
+/**
+ * @brief Waits until every task of the current batch is finished.
+ */
+void waitThreadPoolBatch( ThreadPool *pool ) {
+    pthread_mutex_lock( &pool->mutex );
+    while ( pool->pendingTasks > 0 ) {
+        pthread_cond_wait( &pool->batchFinished, &pool->mutex );
+    }
+    pthread_mutex_unlock( &pool->mutex );
+}
+
+/**
+ * @brief Returns true if every task of the current batch is finished,
+ * without waiting.
+ */
+bool isThreadPoolBatchFinished( ThreadPool *pool ) {
+    pthread_mutex_lock( &pool->mutex );
+    bool finished = pool->pendingTasks == 0;
+    pthread_mutex_unlock( &pool->mutex );
+    return finished;
+}
+
+/**
+ * @brief Executes a batch and waits for it.
+ */
+void runThreadPoolBatch( ThreadPool *pool, int taskCount, TaskFunction function, void *data ) {
+    startThreadPoolBatch( pool, taskCount, function, data );
+    waitThreadPoolBatch( pool );
+}
+
+/**
+ * @brief Returns the number of processors available, at least 1.
+ */
+int getProcessorCount( void ) {
+#ifdef _WIN32
+    int count = pthread_num_processors_np();
+#else
+    int count = (int) sysconf( _SC_NPROCESSORS_ONLN );
+#endif
+    return count < 1 ? 1 : count;
+}
+
+static void *workerLoop( void *args ) {
+
+    ThreadPool *pool = ( (WorkerArgs*) args )->pool;
+    int worker = ( (WorkerArgs*) args )->worker;
+    free( args );
+
+    unsigned long lastBatch = 0;
+
+    while ( true ) {
+
+        pthread_mutex_lock( &pool->mutex );
+        while ( !pool->stopping && pool->batch == lastBatch ) {
+            pthread_cond_wait( &pool->batchStarted, &pool->mutex );
+        }
+        if ( pool->stopping ) {
+            pthread_mutex_unlock( &pool->mutex );
+            return NULL;
+        }
+        lastBatch = pool->batch;
+        pthread_mutex_unlock( &pool->mutex );
+
+        // a task may belong to a batch started after this one was seen,
+        // so the function is read after the task is taken
+        int task;
+        while ( takeTask( pool, worker, &task ) ) {
+
+            pool->function( pool->data, task, worker );
+
+            pthread_mutex_lock( &pool->mutex );
+            if ( --pool->pendingTasks == 0 ) {
+                pthread_cond_broadcast( &pool->batchFinished );
+            }
+            pthread_mutex_unlock( &pool->mutex );
+
+        }
+
+    }
+
+}
+
+/**
+ * @brief Takes the next task from the front of the worker's own range or,
+ * when it is empty, steals one from the back of another range. Returns
+ * false when every range is empty.
+ */
+static bool takeTask( ThreadPool *pool, int worker, int *task ) {
+
+    TaskRange *range = &pool->ranges[worker];
+    pthread_mutex_lock( &range->mutex );
+    if ( range->head < range->tail ) {
+        *task = range->head++;
+        pthread_mutex_unlock( &range->mutex );
+        return true;
+    }
+    pthread_mutex_unlock( &range->mutex );
+
+    for ( int i = 1; i < pool->threadCount; i++ ) {
+        TaskRange *victim = &pool->ranges[( worker + i ) % pool->threadCount];
+        pthread_mutex_lock( &victim->mutex );
+        if ( victim->head < victim->tail ) {
+            *task = --victim->tail;
+            pthread_mutex_unlock( &victim->mutex );
+            return true;
+        }
+        pthread_mutex_unlock( &victim->mutex );
+    }
+
+    return false;
+
+}
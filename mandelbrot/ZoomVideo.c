@@ -0,0 +1,349 @@
+/**
+ * @file ZoomVideo.c
+ * @author Prof. Dr. David Buzatto
+ * @brief ZoomVideo implementation.
+ *
+ * @copyright Copyright (c) 2024
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <ctype.h>
+#include <math.h>
+
+#include "ZoomVideo.h"
+#include "EscapeKernel.h"
+#include "Fractal.h"
+#include "Poster.h"
+#include "ThreadPool.h"
+
+#include "raylib.h"
+#include "raymath.h"
+
+// the samples of the frame being computed (current) and of the previous
+// one; the buffers of both are swapped at each frame
+typedef struct ZoomFrames {
+    FractalParams params;
+    const FractalPalette *palette;
+    EscapeKernel kernel;
+    int width;
+    int height;
+    int current;
+    int *iterations[2];
+    double *smooth[2];
+    double *sampleX[2];         // real part of the samples of each column
+    double *sampleY[2];         // imaginary part of the samples of each line
+    int *columnSources;         // reused column of the previous frame, or -1
+    int *lineSources;           // reused line of the previous frame, or -1
+    Color *pixels[2];
+} ZoomFrames;
+
+static int prepareFrame( ZoomFrames *frames, const FractalParams *params,
+                         double targetX, double targetY, double scale, bool first );
+static int matchSamples( const double *previous, double min, double max, int count,
+                         double *samples, int *sources );
+static void renderFrameLine( void *data, int task, int worker );
+static void writeY4mFrame( FILE *file, const Color *pixels, int width, int height, uint8_t *planes );
+static bool isFramePattern( const char *fileName );
+
+/**
+ * @brief Renders frameCount width x height frames of a zoom of zoom times
+ * into the fractal of params (except for perturbation and histogram
+ * coloring), from the region of params to it divided by zoom around
+ * targetX + targetY*i, that keeps its place in the image. fileName ends
+ * with .y4m for a video or is a pattern for the images of the frames,
+ * with one integer conversion for the number of the frame (like
+ * frame%05d.png). threadCount threads compute the frames. Returns false
+ * if some file could not be written.
+ */
+bool renderFractalZoomVideo( const FractalParams *params, int width, int height,
+                             double targetX, double targetY, double zoom, int frameCount,
+                             const char *fileName, int threadCount, ZoomVideoStats *stats ) {
+
+    const char *extension = strrchr( fileName, '.' );
+    bool y4m = extension != NULL &&
+               ( strcmp( extension, ".y4m" ) == 0 || strcmp( extension, ".Y4M" ) == 0 );
+    FILE *file = NULL;
+
+    if ( y4m ) {
+        file = fopen( fileName, "wb" );
+        if ( file == NULL ) {
+            return false;
+        }
+        setvbuf( file, NULL, _IOFBF, 1 << 20 );
+        // based on https://wiki.multimedia.cx/index.php/YUV4MPEG2
+        fprintf( file, "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 C444\n",
+                 width, height, ZOOM_VIDEO_FRAME_RATE );
+    } else if ( !isFramePattern( fileName ) ) {
+        return false;
+    }
+
+    double startTime = getRenderSeconds();
+
+    FractalParams videoParams = *params;
+    videoParams.perturbation = false;
+    videoParams.subdivision = false;
+    videoParams.showSubdivision = false;
+    videoParams.histogram = false;
+
+    FractalPalette palette = { 0 };
+    updateFractalPalette( &palette, &videoParams );
+
+    ThreadPool *pool = createThreadPool( threadCount );
+
+    ZoomFrames frames = {
+        .params = videoParams,
+        .palette = &palette,
+        .kernel = getEscapeKernel(),
+        .width = width,
+        .height = height,
+        .current = 0,
+        .columnSources = (int*) malloc( sizeof( int ) * width ),
+        .lineSources = (int*) malloc( sizeof( int ) * height )
+    };
+    for ( int i = 0; i < 2; i++ ) {
+        frames.iterations[i] = (int*) malloc( sizeof( int ) * width * height );
+        frames.smooth[i] = (double*) malloc( sizeof( double ) * width * height );
+        frames.sampleX[i] = (double*) malloc( sizeof( double ) * width );
+        frames.sampleY[i] = (double*) malloc( sizeof( double ) * height );
+        frames.pixels[i] = (Color*) malloc( sizeof( Color ) * width * height );
+    }
+    uint8_t *planes = y4m ? (uint8_t*) malloc( (size_t) width * height * 3 ) : NULL;
+
+    double reused = 0;
+    bool written = true;
+    char frameName[1024];
+
+    // while a frame is written the next one is computed
+    for ( int f = 0; f <= frameCount; f++ ) {
+
+        int finished = frames.current;
+
+        if ( f < frameCount ) {
+            double scale = frameCount > 1 ? pow( zoom, f / (double) ( frameCount - 1 ) ) : 1;
+            reused += prepareFrame( &frames, &videoParams, targetX, targetY, scale, f == 0 );
+            startThreadPoolBatch( pool, height, renderFrameLine, &frames );
+        }
+
+        if ( f > 0 ) {
+            const Color *pixels = frames.pixels[finished];
+            if ( y4m ) {
+                writeY4mFrame( file, pixels, width, height, planes );
+            } else {
+                snprintf( frameName, sizeof( frameName ), fileName, f - 1 );
+                written = writeFractalImage( pixels, width, height, frameName ) && written;
+            }
+        }
+
+        if ( f < frameCount ) {
+            waitThreadPoolBatch( pool );
+        }
+
+    }
+
+    destroyThreadPool( pool );
+    for ( int i = 0; i < 2; i++ ) {
+        free( frames.iterations[i] );
+        free( frames.smooth[i] );
+        free( frames.sampleX[i] );
+        free( frames.sampleY[i] );
+        free( frames.pixels[i] );
+    }
+    free( frames.columnSources );
+    free( frames.lineSources );
+    free( planes );
+    freeFractalPalette( &palette );
+
+    if ( y4m ) {
+        written = !ferror( file );
+        written = fclose( file ) == 0 && written;
+    }
+
+    if ( stats != NULL ) {
+        stats->frames = frameCount;
+        stats->seconds = getRenderSeconds() - startTime;
+        stats->framesPerSecond = frameCount / stats->seconds;
+        stats->reusedFraction = frameCount > 0 ? reused / ( (double) width * height * frameCount ) : 0;
+    }
+
+    return written;
+
+}
+
+/**
+ * @brief Moves to the next frame, whose region is the one of params
+ * scaled down by scale around the target, and matches its samples with
+ * the ones of the previous frame (there is none for the first). Returns
+ * how many samples are reused.
+ */
+static int prepareFrame( ZoomFrames *frames, const FractalParams *params,
+                         double targetX, double targetY, double scale, bool first ) {
+
+    int previous = frames->current;
+    int current = 1 - previous;
+    frames->current = current;
+
+    FractalParams *p = &frames->params;
+    p->minX = targetX + ( params->minX - targetX ) / scale;
+    p->maxX = targetX + ( params->maxX - targetX ) / scale;
+    p->minY = targetY + ( params->minY - targetY ) / scale;
+    p->maxY = targetY + ( params->maxY - targetY ) / scale;
+
+    int columns = matchSamples( first ? NULL : frames->sampleX[previous], p->minX, p->maxX,
+                                frames->width, frames->sampleX[current], frames->columnSources );
+    int lines = matchSamples( first ? NULL : frames->sampleY[previous], p->minY, p->maxY,
+                              frames->height, frames->sampleY[current], frames->lineSources );
+
+    return columns * lines;
+
+}
+
+/**
+ * @brief Chooses the samples of the count pixels from min to max along
+ * one axis: the nearest sample of the previous frame if it lies inside
+ * the pixel (sources gets its index), otherwise the point of the pixel
+ * (and -1). Returns how many samples are reused.
+ */
+static int matchSamples( const double *previous, double min, double max, int count,
+                         double *samples, int *sources ) {
+
+    double halfPixel = ( max - min ) / count / 2;
+    int reused = 0;
+    int k = 0;
+
+    for ( int j = 0; j < count; j++ ) {
+
+        // the same point computeFractalPoints uses for the pixel
+        double point = Lerp( min, max, j / (double) count );
+        samples[j] = point;
+        sources[j] = -1;
+
+        if ( previous == NULL ) {
+            continue;
+        }
+
+        // both sequences increase, so the nearest sample never goes back
+        while ( k + 1 < count && fabs( previous[k+1] - point ) <= fabs( previous[k] - point ) ) {
+            k++;
+        }
+
+        if ( fabs( previous[k] - point ) < halfPixel ) {
+            samples[j] = previous[k];
+            sources[j] = k;
+            reused++;
+        }
+
+    }
+
+    return reused;
+
+}
+
+/**
+ * @brief Copies the reused samples of one line of the current frame,
+ * computes the others and colors the line.
+ */
+static void renderFrameLine( void *data, int task, int worker ) {
+
+    ZoomFrames *frames = (ZoomFrames*) data;
+    int width = frames->width;
+    int current = frames->current;
+    int previous = 1 - current;
+
+    int *iterations = &frames->iterations[current][task*width];
+    double *smooth = &frames->smooth[current][task*width];
+    int lineSource = frames->lineSources[task];
+    const int *previousIterations = NULL;
+    const double *previousSmooth = NULL;
+    if ( lineSource >= 0 ) {
+        previousIterations = &frames->iterations[previous][lineSource*width];
+        previousSmooth = &frames->smooth[previous][lineSource*width];
+    }
+    double y = frames->sampleY[current][task];
+
+    int columns[MAX_ROW_LENGTH];
+    double xs[MAX_ROW_LENGTH];
+    double ys[MAX_ROW_LENGTH];
+    int computedIterations[MAX_ROW_LENGTH];
+    double computedSmooth[MAX_ROW_LENGTH];
+    FractalCounters counters = { 0 };
+    int count = 0;
+
+    for ( int j = 0; j < width; j++ ) {
+
+        int columnSource = frames->columnSources[j];
+        if ( lineSource >= 0 && columnSource >= 0 ) {
+            iterations[j] = previousIterations[columnSource];
+            smooth[j] = previousSmooth[columnSource];
+        } else {
+            columns[count] = j;
+            xs[count] = frames->sampleX[current][j];
+            ys[count] = y;
+            count++;
+        }
+
+        if ( count == MAX_ROW_LENGTH || ( j == width - 1 && count > 0 ) ) {
+            computeFractalSamples( &frames->params, frames->kernel, NULL, xs, ys, count,
+                                   computedIterations, computedSmooth, &counters );
+            for ( int k = 0; k < count; k++ ) {
+                iterations[columns[k]] = computedIterations[k];
+                smooth[columns[k]] = computedSmooth[k];
+            }
+            count = 0;
+        }
+
+    }
+
+    colorFractalRow( &frames->params, frames->palette, iterations, smooth, width,
+                     &frames->pixels[current][task*width] );
+
+}
+
+/**
+ * @brief Writes a frame of a Y4M stream, converting the pixels to Y'CbCr
+ * (BT.601, studio range) without subsampling.
+ */
+static void writeY4mFrame( FILE *file, const Color *pixels, int width, int height, uint8_t *planes ) {
+
+    int size = width * height;
+    uint8_t *y = planes;
+    uint8_t *cb = planes + size;
+    uint8_t *cr = planes + 2 * size;
+
+    // based on https://en.wikipedia.org/wiki/YCbCr#ITU-R_BT.601_conversion
+    // (the offsets of 128 * 256 keep the sums positive for the shifts)
+    for ( int k = 0; k < size; k++ ) {
+        int r = pixels[k].r;
+        int g = pixels[k].g;
+        int b = pixels[k].b;
+        y[k] = ( ( 66 * r + 129 * g + 25 * b + 128 ) >> 8 ) + 16;
+        cb[k] = ( -38 * r - 74 * g + 112 * b + 128 + 128 * 256 ) >> 8;
+        cr[k] = ( 112 * r - 94 * g - 18 * b + 128 + 128 * 256 ) >> 8;
+    }
+
+    fputs( "FRAME\n", file );
+    fwrite( planes, 1, (size_t) size * 3, file );
+
+}
+
+/**
+ * @brief Checks that the name of the images has exactly one conversion,
+ * an integer one (%d, with an optional width like %05d).
+ */
+static bool isFramePattern( const char *fileName ) {
+
+    const char *conversion = strchr( fileName, '%' );
+    if ( conversion == NULL ) {
+        return false;
+    }
+
+    const char *c = conversion + 1;
+    while ( isdigit( (unsigned char) *c ) ) {
+        c++;
+    }
+
+    return *c == 'd' && strchr( c, '%' ) == NULL;
+
+}
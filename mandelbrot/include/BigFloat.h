@@ -0,0 +1,70 @@
+/**
+ * @file BigFloat.h
+ * @author Prof. Dr. David Buzatto
+ * @brief BigFloat struct and function declarations. Signed fixed point
+ * numbers with a 32-bit integer part and up to BIG_FLOAT_LIMBS 32-bit
+ * fractional digits, enough for the coordinates of very deep zooms
+ * (a double has 53 bits of precision, BIG_FLOAT_LIMBS digits have 1152).
+ *
+ * @copyright Copyright (c) 2024
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define BIG_FLOAT_LIMBS 36
+
+typedef struct BigFloat {
+    bool negative;
+    int limbs;                              // fractional digits in use
+    uint32_t digits[BIG_FLOAT_LIMBS+1];     // digits[0] is the integer part
+} BigFloat;
+
+/**
+ * @brief Creates a BigFloat with the value of a double (which must be
+ * smaller than 2^32 in magnitude) and limbs fractional digits.
+ */
+BigFloat bigFloatFromDouble( double value, int limbs );
+
+/**
+ * @brief Returns the double closest to x (truncated).
+ */
+double bigFloatToDouble( const BigFloat *x );
+
+/**
+ * @brief Changes the number of fractional digits of x, truncating it or
+ * completing it with zeros.
+ */
+void setBigFloatLimbs( BigFloat *x, int limbs );
+
+/**
+ * @brief Returns the number of fractional digits needed to locate points
+ * spaced by pixelSize without losing precision.
+ */
+int getBigFloatLimbsFor( double pixelSize );
+
+/**
+ * @brief result = a + b, with the precision of the most precise of them.
+ */
+void bigFloatAdd( BigFloat *result, const BigFloat *a, const BigFloat *b );
+
+/**
+ * @brief result = a - b, with the precision of the most precise of them.
+ */
+void bigFloatSub( BigFloat *result, const BigFloat *a, const BigFloat *b );
+
+/**
+ * @brief result = a * b, with the precision of the most precise of them.
+ */
+void bigFloatMul( BigFloat *result, const BigFloat *a, const BigFloat *b );
+
+/**
+ * @brief x = x + value, keeping the precision of x.
+ */
+void bigFloatAddDouble( BigFloat *x, double value );
+
+/**
+ * @brief Returns true if a and b have the same value.
+ */
+bool bigFloatEquals( const BigFloat *a, const BigFloat *b );
@@ -0,0 +1,46 @@
+/**
+ * @file EscapeKernel.h
+ * @author Prof. Dr. David Buzatto
+ * @brief Escape-time iteration of z = z^2 + c for many points at once.
+ * There is a scalar kernel and, on x86 processors, AVX2 (8 points at a
+ * time) and AVX-512 (16 points at a time) kernels; the fastest one the
+ * processor supports is selected at run time. All kernels produce the
+ * same results.
+ *
+ * @copyright Copyright (c) 2024
+ */
+#pragma once
+
+#include <stdbool.h>
+
+/**
+ * @brief Iterates z = z^2 + c, starting at z = zx0[k] + zy0[k]*i with
+ * c = cx[k] + cy[k]*i, while |z|^2 < bailout (or <= bailout if inclusive)
+ * and up to maxIterations times, storing the iterations executed and the
+ * last z of each of the count points. Points whose orbit is found
+ * periodic are stopped with maxIterations; returns how many they were.
+ */
+typedef int (*EscapeKernel)( const double *zx0, const double *zy0,
+                             const double *cx, const double *cy,
+                             int count, int maxIterations,
+                             double bailout, bool inclusive,
+                             int *iterations, double *zx, double *zy );
+
+/**
+ * @brief Returns the fastest kernel the processor supports.
+ */
+EscapeKernel getEscapeKernel( void );
+
+/**
+ * @brief Returns the name of the kernel returned by getEscapeKernel.
+ */
+const char *getEscapeKernelName( void );
+
+/**
+ * @brief Kernel that iterates one point at a time.
+ */
+int escapeScalar( const double *zx0, const double *zy0,
+                  const double *cx, const double *cy,
+                  int count, int maxIterations,
+                  double bailout, bool inclusive,
+                  int *iterations, double *zx, double *zy );
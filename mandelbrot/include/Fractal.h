@@ -0,0 +1,170 @@
+/**
+ * @file Fractal.h
+ * @author Prof. Dr. David Buzatto
+ * @brief Fractal parameters and escape-time function declarations.
+ *
+ * @copyright Copyright (c) 2024
+ */
+#pragma once
+
+#include <stdbool.h>
+
+#include "raylib.h"
+#include "EscapeKernel.h"
+#include "BigFloat.h"
+#include "Perturbation.h"
+
+#define MAX_ROW_LENGTH 64
+#define MAX_SUBDIVISION_SIZE 256
+
+/**
+ * @brief Everything that defines the rendered image: the visible region
+ * of the complex plane, the fractal (Mandelbrot or Julia for the c =
+ * cx + cy*i constant) and its coloring. With perturbation (deep zoom of
+ * the Mandelbrot set), the region is relative to centerX + centerY*i.
+ * With subdivision, the Mandelbrot set is computed by Mariani-Silver
+ * subdivision, and showSubdivision marks the filled rectangles. With
+ * histogram, the colors are spread by the number of pixels of each
+ * iteration count (histogram equalization) instead of by the count.
+ * With antialiasing, the pixels at the edges between iteration counts
+ * get the mean color of several samples.
+ */
+typedef struct FractalParams {
+    double minX;
+    double maxX;
+    double minY;
+    double maxY;
+    bool mandelbrot;
+    bool colored;
+    bool gradient;
+    int maxIterations;
+    double cx;
+    double cy;
+    double scapeRadius;
+    double hueStart;
+    double hueEnd;
+    bool perturbation;
+    BigFloat centerX;
+    BigFloat centerY;
+    bool subdivision;
+    bool showSubdivision;
+    bool histogram;
+    bool antialiasing;
+} FractalParams;
+
+typedef enum FractalChange {
+    FRACTAL_UNCHANGED = 0,
+    FRACTAL_VIEW_CHANGED = 1,       // region, fractal or iterations
+    FRACTAL_COLORS_CHANGED = 2      // coloring only
+} FractalChange;
+
+/**
+ * @brief Colors of the iteration counts of an image, computed once each
+ * time the coloring changes: colors[PALETTE_MARGIN + k] is the color of
+ * k iterations, for k from -PALETTE_MARGIN to maxIterations + 1 (smooth
+ * values can be a few units below zero).
+ */
+typedef struct FractalPalette {
+    Color *colors;
+    int capacity;
+    int maxIterations;
+} FractalPalette;
+
+#define PALETTE_MARGIN 8
+
+/**
+ * @brief How many pixels skipped the iteration of z = z^2 + c.
+ */
+typedef struct FractalCounters {
+    int iterated;   // escape time computed by iteration
+    int interior;   // inside the main cardioid or the period-2 bulb
+    int periodic;   // orbit found periodic while iterating
+    int filled;     // inside a rectangle filled by subdivision
+} FractalCounters;
+
+/**
+ * @brief Computes the escape time of the pixels startColumn to endColumn
+ * - 1 (at most MAX_ROW_LENGTH) of the line py of a width x height image
+ * of the fractal: the iteration count and the smooth (fractional) value
+ * derived from the last |z|^2. orbit is the reference orbit of the center
+ * when params use perturbation. The pixels that skipped the iteration are
+ * added to counters.
+ */
+void computeFractalRow( const FractalParams *params, EscapeKernel kernel,
+                        const ReferenceOrbit *orbit,
+                        int py, int startColumn, int endColumn,
+                        int width, int height, 
+                        int *iterations, double *smooth,
+                        FractalCounters *counters );
+
+/**
+ * @brief Computes the escape time of count (at most MAX_ROW_LENGTH)
+ * pixels of any lines and columns of a width x height image, like
+ * computeFractalRow.
+ */
+void computeFractalPoints( const FractalParams *params, EscapeKernel kernel,
+                           const ReferenceOrbit *orbit,
+                           const int *lines, const int *columns, int count,
+                           int width, int height, 
+                           int *iterations, double *smooth,
+                           FractalCounters *counters );
+
+/**
+ * @brief Computes the escape time of count (at most MAX_ROW_LENGTH)
+ * points x + y*i of the complex plane (offsets from the center with
+ * perturbation), like computeFractalRow.
+ */
+void computeFractalSamples( const FractalParams *params, EscapeKernel kernel,
+                            const ReferenceOrbit *orbit,
+                            const double *x, const double *y, int count,
+                            int *iterations, double *smooth,
+                            FractalCounters *counters );
+
+/**
+ * @brief Computes the escape times of the rectangle of lines startLine
+ * to endLine - 1 and columns startColumn to endColumn - 1 of a width x
+ * height image of the Mandelbrot set by Mariani-Silver subdivision: only
+ * the border of the rectangle is iterated; if every pixel of the border
+ * has the same iteration count the interior is filled with it, otherwise
+ * the rectangle is split in two and each half is processed the same way.
+ * iterations, smooth and filled hold the whole image; filled marks the
+ * pixels that were filled instead of iterated. The rectangle can have at
+ * most MAX_SUBDIVISION_SIZE lines.
+ */
+void computeFractalRectangle( const FractalParams *params, EscapeKernel kernel,
+                              const ReferenceOrbit *orbit,
+                              int startLine, int endLine, int startColumn, int endColumn,
+                              int width, int height,
+                              int *iterations, double *smooth, bool *filled,
+                              FractalCounters *counters );
+
+/**
+ * @brief Computes the colors of count pixels from their escape times.
+ */
+void colorFractalRow( const FractalParams *params, const FractalPalette *palette,
+                      const int *iterations, const double *smooth, 
+                      int count, Color *colors );
+
+/**
+ * @brief Fills the palette for the coloring of params.
+ */
+void updateFractalPalette( FractalPalette *palette, const FractalParams *params );
+
+/**
+ * @brief Fills the palette for the histogram coloring of params, where
+ * cumulative[k] is how many escaped pixels took less than k iterations,
+ * for k from 0 to maxIterations (that is, the count of all of them).
+ */
+void updateFractalHistogramPalette( FractalPalette *palette, const FractalParams *params,
+                                    const int *cumulative );
+
+/**
+ * @brief Frees the colors of the palette.
+ */
+void freeFractalPalette( FractalPalette *palette );
+
+/**
+ * @brief Returns which parts of the image change from oldParams to
+ * newParams, as a combination of FractalChange flags.
+ */
+int getFractalChanges( const FractalParams *oldParams, const FractalParams *newParams );
@@ -0,0 +1,173 @@
+/**
+ * @file FractalRenderer.h
+ * @author Prof. Dr. David Buzatto
+ * @brief FractalRenderer struct and function declarations. The image is
+ * split in TILE_SIZE x TILE_SIZE tiles that are computed in background by
+ * a thread pool into a pixel buffer; finished tiles are uploaded to a
+ * single texture, so the window keeps responding while a slow image is
+ * computed. The escape times are kept, so a change of colors only
+ * colors them again.
+ *
+ * Each view is rendered in PASS_COUNT passes: the first one iterates one
+ * pixel of each COARSEST_STEP x COARSEST_STEP block and draws the block
+ * with its color, and each of the next ones halves the blocks, iterating
+ * only the pixels that the previous passes did not, until the last one
+ * gets to the full resolution. A pass starts when the previous one is
+ * completely uploaded.
+ *
+ * The histogram coloring needs every escape time of the pass before
+ * coloring any pixel: the tiles are computed first, then the histogram
+ * of the iteration counts is built and accumulated (a prefix sum) in
+ * parallel, and then the tiles are colored.
+ *
+ * With anti-aliasing, a refinement stage follows the last pass: each
+ * pixel whose iteration count differs from the one of a neighbor is
+ * sampled again on a jittered SUPERSAMPLING_GRID x SUPERSAMPLING_GRID
+ * grid and takes the mean color of the samples. Only the edges are
+ * refined, a small part of the cost of supersampling the whole image.
+ * The escape times of the samples are kept too, so a change of colors
+ * colors the refined edges again without iterating them.
+ *
+ * @copyright Copyright (c) 2024
+ */
+#pragma once
+
+#include <stdbool.h>
+
+#include "raylib.h"
+#include "EscapeKernel.h"
+#include "Fractal.h"
+#include "Perturbation.h"
+#include "ThreadPool.h"
+
+#define TILE_SIZE 32
+#define COARSEST_STEP 8
+#define PASS_COUNT 4
+#define HISTOGRAM_TASKS 64
+#define SUPERSAMPLING_GRID 4
+
+/**
+ * @brief The samples of the refined pixels of a tile, in the order they
+ * were refined: SUPERSAMPLING_GRID^2 escape times for each pixel.
+ */
+typedef struct RefinedTile {
+    int view;               // of the samples, 0 if there are none
+    int count;
+    int capacity;
+    int *pixels;            // index of each pixel in the image
+    int *iterations;
+    double *smooth;
+} RefinedTile;
+
+typedef struct FractalRenderer {
+
+    int width;
+    int height;
+    int tileLines;
+    int tileColumns;
+    int tileCount;
+
+    ThreadPool *pool;
+    EscapeKernel kernel;
+
+    // set before each render starts, read by the workers
+    FractalParams params;
+    FractalPalette palette;
+    ReferenceOrbit orbit;
+    int render;
+    int view;               // changes only when the escape times change
+    int pass;               // 0 to PASS_COUNT - 1
+    bool started;
+    bool histogramReady;    // the palette has the histogram of the pass
+    bool refining;          // supersampling the edges of the last pass
+    bool refined;           // the last pass colored the kept samples of every edge
+
+    // written by the workers
+    int *iterations;
+    double *smooth;
+    bool *filled;           // filled by subdivision instead of iterated
+    int *tileView;          // view of the escape times of each tile
+    int *tilePass;          // finest pass of the escape times of each tile
+    Color *pixels;
+    int *tileRender;        // render that finished each tile
+    int cancelled;
+    FractalCounters counters;   // of the current view
+    int refinedPixels;      // supersampled by the current refinement
+    RefinedTile *refinedTiles;
+
+    // histogram coloring
+    int *histograms;        // of the pixels of each worker
+    int *cumulative;        // escaped pixels below each iteration count
+    int histogramCapacity;
+    int blockSums[HISTOGRAM_TASKS];
+
+    // used only by the thread that owns the window
+    bool *tileUploaded;
+    int uploadedTiles;
+    Color *tilePixels;
+    Texture2D texture;
+    double recolorTime;
+
+} FractalRenderer;
+
+/**
+ * @brief Creates a dinamically allocated FractalRenderer for width x
+ * height images. Must be called after the window is created.
+ */
+FractalRenderer* createFractalRenderer( int width, int height, int threadCount );
+
+/**
+ * @brief Destroys a FractalRenderer, its thread pool and its texture.
+ */
+void destroyFractalRenderer( FractalRenderer *renderer );
+
+/**
+ * @brief Starts rendering the fractal if params change the image of the
+ * last render, canceling the tiles of the previous one that were not
+ * computed yet. Returns the changes, as FractalChange flags. When only
+ * the colors of a complete image change, it is colored again before
+ * returning.
+ */
+int renderFractal( FractalRenderer *renderer, const FractalParams *params );
+
+/**
+ * @brief Uploads the tiles finished since the last call to the texture
+ * and, if the current pass is complete, starts the next one.
+ */
+void updateFractalTexture( FractalRenderer *renderer );
+
+/**
+ * @brief Returns the fraction (0 to 1) of the pixels of the current
+ * render that are iterated and uploaded to the texture (of the tiles,
+ * while refining).
+ */
+double getFractalRenderProgress( const FractalRenderer *renderer );
+
+/**
+ * @brief Returns the size of the blocks of pixels drawn with the same
+ * color by the current pass: COARSEST_STEP in the first one, 1 in the
+ * last.
+ */
+int getFractalRenderStep( const FractalRenderer *renderer );
+
+/**
+ * @brief Returns true when the texture holds the whole current render,
+ * at full resolution and, with anti-aliasing, refined.
+ */
+bool isFractalRenderFinished( const FractalRenderer *renderer );
+
+/**
+ * @brief Returns how many pixels of the current view skipped the
+ * iteration so far.
+ */
+FractalCounters getFractalCounters( const FractalRenderer *renderer );
+
+/**
+ * @brief Returns how many pixels the anti-aliasing supersampled so far.
+ */
+int getFractalRefinedPixels( const FractalRenderer *renderer );
+
+/**
+ * @brief Draws the texture with the fractal.
+ */
+void drawFractal( const FractalRenderer *renderer );
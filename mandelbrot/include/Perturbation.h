@@ -0,0 +1,43 @@
+/**
+ * @file Perturbation.h
+ * @author Prof. Dr. David Buzatto
+ * @brief Deep zoom of the Mandelbrot set by perturbation. The orbit of
+ * one reference point C (the center of the view) is computed with
+ * BigFloat precision; every pixel c = C + dc is then iterated in double
+ * precision as the difference d between its orbit and the reference
+ * one: d' = ( 2Z + d )d + dc. The differences stay tiny while the
+ * coordinates need hundreds of bits, so the doubles are enough.
+ *
+ * @copyright Copyright (c) 2024
+ */
+#pragma once
+
+#include "BigFloat.h"
+
+typedef struct ReferenceOrbit {
+    double *x;
+    double *y;
+    int length;
+    int capacity;
+} ReferenceOrbit;
+
+/**
+ * @brief Computes the orbit of c = cx + cy*i, up to maxIterations or
+ * until it escapes, rounding each point to doubles.
+ */
+void computeReferenceOrbit( ReferenceOrbit *orbit, const BigFloat *cx, const BigFloat *cy, int maxIterations );
+
+/**
+ * @brief Frees the points of the orbit.
+ */
+void freeReferenceOrbit( ReferenceOrbit *orbit );
+
+/**
+ * @brief Iterates the count points c = C + dcx[k] + dcy[k]*i by
+ * perturbation of the reference orbit of C while |z|^2 <= bailout and up
+ * to maxIterations times, storing the iterations executed and the last z
+ * of each point. Returns how many times the points were rebased.
+ */
+int escapePerturbed( const ReferenceOrbit *orbit, const double *dcx, const double *dcy,
+                     int count, int maxIterations, double bailout,
+                     int *iterations, double *zx, double *zy );
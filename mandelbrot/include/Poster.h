@@ -0,0 +1,46 @@
+/**
+ * @file Poster.h
+ * @author Prof. Dr. David Buzatto
+ * @brief Headless rendering of images of the fractal too big to be kept
+ * in memory (32768 x 32768 pixels are 4 GB of RGBA). The image is
+ * computed in strips of POSTER_STRIP_LINES lines by a thread pool and
+ * each strip is written to the file while the next one is computed, so
+ * only two strips are in memory at a time. The file is a PPM or a PNG
+ * (with uncompressed deflate blocks, so no compression library is
+ * needed), chosen by its extension.
+ *
+ * @copyright Copyright (c) 2024
+ */
+#pragma once
+
+#include <stdbool.h>
+
+#include "Fractal.h"
+
+#define POSTER_STRIP_LINES 64
+
+typedef struct PosterStats {
+    double seconds;
+    double megapixelsPerSecond;
+} PosterStats;
+
+/**
+ * @brief Renders a width x height image of the fractal of params (except
+ * for perturbation and histogram coloring) to fileName (.png or .ppm)
+ * using threadCount threads. Returns false if the file could not be
+ * written.
+ */
+bool renderFractalPoster( const FractalParams *params, int width, int height,
+                          const char *fileName, int threadCount, PosterStats *stats );
+
+/**
+ * @brief Writes a width x height image to fileName (.png or .ppm).
+ * Returns false if the file could not be written.
+ */
+bool writeFractalImage( const Color *pixels, int width, int height, const char *fileName );
+
+/**
+ * @brief Returns the wall clock time in seconds, for the headless
+ * renderers, that have no window (and no GetTime).
+ */
+double getRenderSeconds( void );
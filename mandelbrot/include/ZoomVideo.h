@@ -0,0 +1,42 @@
+/**
+ * @file ZoomVideo.h
+ * @author Prof. Dr. David Buzatto
+ * @brief Headless rendering of zoom animations of the fractal, as a raw
+ * Y4M video stream or a sequence of images. Consecutive frames of a zoom
+ * overlap, so each frame reuses the escape times of the previous one: a
+ * sample of the previous frame is kept when it lies inside a pixel of
+ * the new one (as its sample, instead of the center of the pixel), and
+ * only the other pixels are computed. The samples are matched by column
+ * and by line, so a pixel is reused when both its column and its line
+ * are.
+ *
+ * @copyright Copyright (c) 2024
+ */
+#pragma once
+
+#include <stdbool.h>
+
+#include "Fractal.h"
+
+#define ZOOM_VIDEO_FRAME_RATE 30
+
+typedef struct ZoomVideoStats {
+    int frames;
+    double seconds;
+    double framesPerSecond;
+    double reusedFraction;      // of all the samples of all frames
+} ZoomVideoStats;
+
+/**
+ * @brief Renders frameCount width x height frames of a zoom of zoom times
+ * into the fractal of params (except for perturbation and histogram
+ * coloring), from the region of params to it divided by zoom around
+ * targetX + targetY*i, that keeps its place in the image. fileName ends
+ * with .y4m for a video or is a pattern for the images of the frames,
+ * with one integer conversion for the number of the frame (like
+ * frame%05d.png). threadCount threads compute the frames. Returns false
+ * if some file could not be written.
+ */
+bool renderFractalZoomVideo( const FractalParams *params, int width, int height,
+                             double targetX, double targetY, double zoom, int frameCount,
+                             const char *fileName, int threadCount, ZoomVideoStats *stats );
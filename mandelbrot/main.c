@@ -24,11 +24,17 @@
 /*---------------------------------------------
  * Project headers.
  --------------------------------------------*/
+#include "EscapeKernel.h"
+#include "BigFloat.h"
+#include "Fractal.h"
+#include "FractalRenderer.h"
+#include "Poster.h"
+#include "ThreadPool.h"
+#include "ZoomVideo.h"
 
 /*---------------------------------------------
  * Macros. 
  --------------------------------------------*/
-#define MAX_ZOOM 15
 
 /*--------------------------------------------
  * Constants. 
@@ -51,6 +57,18 @@ const double MIN_HUE = 0;
 const double MAX_HUE = 360;
 const double COMPLEX_REAL_IMAGINARY_LIMIT = 2;
 
+// below this the differences between pixels do not fit in doubles
+const double MIN_DEEP_ZOOM_RADIUS = 1e-290;
+
+// size of the posters of the command copied with the P key
+const int POSTER_SIZE = 16384;
+const int POSTER_ARGUMENTS = 17;
+
+// size and speed of the zoom videos of the command copied with the V key
+const int ZOOM_VIDEO_SIZE = 1080;
+const int ZOOM_VIDEO_FRAMES_PER_DOUBLING = 30;
+const int ZOOM_VIDEO_ARGUMENTS = 21;
+
 /*---------------------------------------------
  * Custom types (enums, structs, unions etc.)
  --------------------------------------------*/
@@ -70,6 +88,18 @@ typedef struct ColorBar {
     SliderControl *hueControlEnd;
 } ColorBar;
 
+typedef struct ZoomLevel {
+    double minX;
+    double maxX;
+    double minY;
+    double maxY;
+    bool deepZoom;
+    BigFloat centerX;
+    BigFloat centerY;
+    double radiusX;
+    double radiusY;
+} ZoomLevel;
+
 typedef struct ComplexBar {
     Vector2 pos;
     int width;
@@ -94,6 +124,8 @@ SliderControl complexControlReal;
 SliderControl complexControlImaginary;
 SliderControl *selectedComplexControl = NULL;
 
+const char *programName;
+
 int xPress;
 int yPress;
 int xOffset;
@@ -108,16 +140,27 @@ bool mandelbrot;
 bool colored;
 bool gradient;
 bool zooming;
+bool subdivision;
+bool showSubdivision;
+bool histogram;
+bool antialiasing;
 int maxIterations;
 
 double cx;
 double cy;
 double scapeRadius;
 
-double lastMinX[MAX_ZOOM];
-double lastMaxX[MAX_ZOOM];
-double lastMinY[MAX_ZOOM];
-double lastMaxY[MAX_ZOOM];
+FractalRenderer *renderer;
+
+// deep zoom: the view is centered at centerX + centerY*i
+bool deepZoom;
+BigFloat centerX;
+BigFloat centerY;
+double radiusX;
+double radiusY;
+
+ZoomLevel *zoomLevels;
+int zoomCapacity;
 int currentZoom;
 
 
@@ -130,6 +173,15 @@ int currentZoom;
  */
 void inputAndUpdate( void );
 int getIteration( double x0, double y0, double x, double y, int maxIterations );
+void pushZoomLevel( void );
+void popZoomLevel( void );
+void zoomDeep( double xStart, double xEnd, double yStart, double yEnd );
+void setDeepZoom( bool enabled );
+FractalParams readFractalParams( char *argv[] );
+int renderPoster( int argc, char *argv[] );
+void copyPosterCommand( void );
+int renderZoomVideo( int argc, char *argv[] );
+void copyZoomVideoCommand( void );
 
 /**
  * @brief Draws the state of the game.
@@ -141,7 +193,19 @@ void drawComplexBar( const ComplexBar *complexBar );
 void drawSliderControl( const SliderControl *sliderControl );
 bool interceptsSliderControlCoord( const SliderControl *sliderControl, int x, int y );
 
-int main( void ) {
+int main( int argc, char *argv[] ) {
+
+    programName = argv[0];
+
+    // headless render of a big image, without a window
+    if ( argc > 1 && strcmp( argv[1], "--poster" ) == 0 ) {
+        return renderPoster( argc, argv );
+    }
+
+    // headless render of a zoom animation
+    if ( argc > 1 && strcmp( argv[1], "--zoom" ) == 0 ) {
+        return renderZoomVideo( argc, argv );
+    }
 
     SetConfigFlags( FLAG_MSAA_4X_HINT );
     InitWindow( SCREENS_SIZE, SCREENS_SIZE, "Fractais de Mandelbrot e Julia" );
@@ -230,19 +294,30 @@ int main( void ) {
     mandelbrot = START_MANDELBROT;
     colored = START_COLORED;
     gradient = START_GRADIENT;
+    subdivision = false;
+    showSubdivision = false;
+    histogram = false;
+    antialiasing = false;
     maxIterations = START_MAX_ITERATIONS;
     
     cx = complexControlReal.value;
     cy = complexControlImaginary.value;
     scapeRadius = 2;
 
+    deepZoom = false;
+    zoomLevels = NULL;
+    zoomCapacity = 0;
     currentZoom = 0;
 
+    renderer = createFractalRenderer( SCREENS_SIZE, SCREENS_SIZE, getProcessorCount() );
+
     while ( !WindowShouldClose() ) {
         inputAndUpdate();
         draw();
     }
 
+    destroyFractalRenderer( renderer );
+    free( zoomLevels );
     CloseAudioDevice();
     CloseWindow();
     return 0;
@@ -313,13 +388,9 @@ void inputAndUpdate( void ) {
 
     if ( wheelMove > 0 ) {
 
-        if ( currentZoom < MAX_ZOOM ) {
+        if ( !deepZoom || radiusX * ZOOM_SQUARE_SIZE / GetScreenWidth() >= MIN_DEEP_ZOOM_RADIUS ) {
 
-            lastMinX[currentZoom] = minX;
-            lastMaxX[currentZoom] = maxX;
-            lastMinY[currentZoom] = minY;
-            lastMaxY[currentZoom] = maxY;
-            currentZoom++;
+            pushZoomLevel();
 
             double xStart = GetMouseX() - ZOOM_SQUARE_SIZE / 2;
             double xEnd = GetMouseX() + ZOOM_SQUARE_SIZE / 2;
@@ -342,24 +413,24 @@ void inputAndUpdate( void ) {
                 yEnd = GetScreenWidth();
             }
 
-            double nMinX = Lerp( minX, maxX, xStart / GetScreenWidth() );
-            double nMaxX = Lerp( minX, maxX, xEnd / GetScreenWidth() );
-            double nMinY = Lerp( minY, maxY, yStart / GetScreenHeight() );
-            double nMaxY = Lerp( minY, maxY, yEnd / GetScreenHeight() );
-            minX = nMinX;
-            maxX = nMaxX;
-            minY = nMinY;
-            maxY = nMaxY;
+            if ( deepZoom ) {
+                zoomDeep( xStart, xEnd, yStart, yEnd );
+            } else {
+                double nMinX = Lerp( minX, maxX, xStart / GetScreenWidth() );
+                double nMaxX = Lerp( minX, maxX, xEnd / GetScreenWidth() );
+                double nMinY = Lerp( minY, maxY, yStart / GetScreenHeight() );
+                double nMaxY = Lerp( minY, maxY, yEnd / GetScreenHeight() );
+                minX = nMinX;
+                maxX = nMaxX;
+                minY = nMinY;
+                maxY = nMaxY;
+            }
 
         }
 
     } else if ( wheelMove < 0 ) {
         if ( currentZoom > 0 ) {
-            currentZoom--;
-            minX = lastMinX[currentZoom];
-            maxX = lastMaxX[currentZoom];
-            minY = lastMinY[currentZoom];
-            maxY = lastMaxY[currentZoom];
+            popZoomLevel();
         }
 
     }
@@ -371,6 +442,10 @@ void inputAndUpdate( void ) {
         if ( maxIterations < 0 ) {
             maxIterations = 0;
         }
+    } else if ( IsKeyPressed( KEY_PAGE_UP ) ) {
+        maxIterations = maxIterations < 10 ? 10 : maxIterations * 2;
+    } else if ( IsKeyPressed( KEY_PAGE_DOWN ) ) {
+        maxIterations /= 2;
     }
 
     if ( IsKeyPressed( KEY_C ) ) {
@@ -381,6 +456,22 @@ void inputAndUpdate( void ) {
         gradient = !gradient;
     }
 
+    if ( IsKeyPressed( KEY_S ) ) {
+        subdivision = !subdivision;
+    }
+
+    if ( IsKeyPressed( KEY_B ) ) {
+        showSubdivision = !showSubdivision;
+    }
+
+    if ( IsKeyPressed( KEY_H ) ) {
+        histogram = !histogram;
+    }
+
+    if ( IsKeyPressed( KEY_A ) ) {
+        antialiasing = !antialiasing;
+    }
+
     if ( IsKeyPressed( KEY_M ) ) {
         minX = MIN_X;
         maxX = MAX_X;
@@ -388,6 +479,7 @@ void inputAndUpdate( void ) {
         maxY = MAX_Y;
         currentZoom = 0;
         mandelbrot = true;
+        setDeepZoom( deepZoom );
     }
 
     if ( IsKeyPressed( KEY_J ) ) {
@@ -397,6 +489,20 @@ void inputAndUpdate( void ) {
         maxY = scapeRadius;
         currentZoom = 0;
         mandelbrot = false;
+        deepZoom = false;
+    }
+
+    if ( IsKeyPressed( KEY_P ) ) {
+        copyPosterCommand();
+    }
+
+    if ( IsKeyPressed( KEY_V ) ) {
+        copyZoomVideoCommand();
+    }
+
+    // perturbation is implemented for the Mandelbrot set only
+    if ( IsKeyPressed( KEY_D ) && mandelbrot ) {
+        setDeepZoom( !deepZoom );
     }
 
     if ( IsKeyPressed( KEY_Z ) ) {
@@ -416,6 +522,7 @@ void inputAndUpdate( void ) {
             maxY = scapeRadius;
         }
         currentZoom = 0;
+        setDeepZoom( deepZoom );
     }
 
     hueControlStart.value = Lerp( MIN_HUE, MAX_HUE, ( hueControlStart.pos.x - colorBar.pos.x ) / colorBar.width );
@@ -433,229 +540,368 @@ void draw( void ) {
     BeginDrawing();
     ClearBackground( WHITE );
 
-    // based on https://en.wikipedia.org/wiki/Mandelbrot_set
-    //          https://en.wikipedia.org/wiki/Julia_set
-    
-    Color color = { 0, 0, 0, 255 };
-
-    for ( int i = 0; i < GetScreenHeight(); i++ ) {
-        for ( int j = 0; j < GetScreenWidth(); j++ ) {
-
-            double px = j;
-            double py = i;
-            double x = 0.0;
-            double y = 0.0;
-            double x0;
-            double y0;
-            double xTemp;
-            int iteration;
-
-            if ( mandelbrot ) {
-
-                // fixed complex number
-                x0 = Lerp( minX, maxX, ( px / GetScreenWidth() ) );   // real
-                y0 = Lerp( minY, maxY, ( py / GetScreenHeight() ) );  // imaginary
-
-                for ( iteration = 0; 
-                      iteration < maxIterations && 
-                      x*x + y*y <= ( 1 << 16 ); 
-                      iteration++ ) {
-                    xTemp = x * x - y * y + x0;
-                    y = 2 * x * y + y0;
-                    x = xTemp;
-                }
+    FractalParams params = {
+        .minX = minX,
+        .maxX = maxX,
+        .minY = minY,
+        .maxY = maxY,
+        .mandelbrot = mandelbrot,
+        .colored = colored,
+        .gradient = gradient,
+        .maxIterations = maxIterations,
+        .cx = cx,
+        .cy = cy,
+        .scapeRadius = scapeRadius,
+        .hueStart = hueControlStart.value,
+        .hueEnd = hueControlEnd.value,
+        .perturbation = deepZoom,
+        .centerX = centerX,
+        .centerY = centerY,
+        .subdivision = subdivision,
+        .showSubdivision = showSubdivision,
+        .histogram = histogram,
+        .antialiasing = antialiasing
+    };
 
-                if ( colored ) {
-
-                    if ( gradient ) {
-
-                        double diff = 0;
-                        if ( iteration < maxIterations ) {
-                            double logZn = log( x * x + y * y ) / 2;
-                            double nu = log( logZn / log(2) ) / log(2);
-                            diff = iteration - 1 - nu;
-                        }
-
-                        double vStart = diff;
-                        double vEnd = diff;
-                        /*double vStart = diff;
-                        double vEnd = iteration;
-                        double vStart = iteration;
-                        double vEnd = diff;
-                        double vStart = iteration;
-                        double vEnd = iteration;*/
-
-                        Color color1 = ColorFromHSV( 
-                                hueControlStart.value + 
-                                ( hueControlEnd.value - hueControlStart.value ) * 
-                                ( ((int) vStart) / (double) maxIterations ), 
-                                1, 0.7 );
-                        Color color2 = ColorFromHSV( 
-                                hueControlStart.value + 
-                                ( hueControlEnd.value - hueControlStart.value ) * 
-                                ( ((int) (vEnd+1)) / (double) maxIterations ), 
-                                1, 0.7 );
-
-                        diff = diff - ((long)diff);
-
-                        color = (Color) {
-                            .r = Lerp( color1.r, color2.r, diff ),
-                            .g = Lerp( color1.g, color2.g, diff ),
-                            .b = Lerp( color1.b, color2.b, diff ),
-                            .a = 255
-                        };
-
-                    } else {
-
-                        color = ColorFromHSV( hueControlStart.value + 
-                            ( hueControlEnd.value - hueControlStart.value ) * 
-                            ( iteration / (double) maxIterations ), 
-                            1, 0.7 );
-
-                    }
-
-                } else {
-
-                    int c;
-                    
-                    if ( gradient ) {
-
-                        double diff = 0;
-                        if ( iteration < maxIterations ) {
-                            double logZn = log( x * x + y * y ) / 2;
-                            double nu = log( logZn / log(2) ) / log(2);
-                            diff = iteration - 1 - nu;
-                        }
-                        
-                        double c1 = 255 * (diff) / ( (double) maxIterations );
-                        double c2 = 255 * (diff+1) / ( (double) maxIterations );
-                        diff = diff - ((long)diff);
-
-                        c = Lerp( c1, c2, diff );
-
-                    } else {
-                        c = 255 - 255 * ( iteration / (double) maxIterations );
-                    }
-
-                    color.r = c;
-                    color.g = c;
-                    color.b = c;
+    if ( deepZoom ) {
+        params.minX = -radiusX;
+        params.maxX = radiusX;
+        params.minY = -radiusY;
+        params.maxY = radiusY;
+    }
 
-                }
+    // the fractal is computed in background, tile by tile, only when
+    // the parameters change the image; the finished tiles replace the
+    // previous image in the texture, that is drawn in every frame
+    renderFractal( renderer, &params );
+    updateFractalTexture( renderer );
+    drawFractal( renderer );
 
-            } else {
+    if ( zooming ) {
+        DrawRectangleLines( 
+            GetMouseX() - ZOOM_SQUARE_SIZE / 2, 
+            GetMouseY() - ZOOM_SQUARE_SIZE / 2, 
+            ZOOM_SQUARE_SIZE, 
+            ZOOM_SQUARE_SIZE, 
+            BLACK );
+    }
 
-                // variyng complex number (min and max related to scapeRadius)
-                x0 = Lerp( minX, maxX, ( px / GetScreenWidth() ) );    // real
-                y0 = Lerp( minY, maxY, ( py / GetScreenHeight() ) );   // imaginary
-                
-                for ( iteration = 0; 
-                      iteration < maxIterations && 
-                      x0*x0 + y0*y0 < scapeRadius*scapeRadius; 
-                      iteration++ ) {
-                    xTemp = x0 * x0 - y0 * y0;
-                    y0 = 2 * x0 * y0 + cy;
-                    x0 = xTemp + cx;
-                }
+    if ( colored ) {
+        drawColorBar( &colorBar );
+    }
+
+    if ( !mandelbrot ) {
+        drawComplexBar( &complexBar );
+    }
+
+    DrawFPS( 20, GetScreenHeight() - 60 );
+    const char *coloring = histogram ? "histograma (H)" : "H: histograma";
+    if ( renderer->recolorTime > 0 ) {
+        DrawText( TextFormat( "%s, %s, cores recalculadas em %.2f ms", 
+                              getEscapeKernelName(), coloring, renderer->recolorTime * 1000 ), 
+                  20, GetScreenHeight() - 80, 20, BLACK );
+    } else {
+        DrawText( TextFormat( "%s, %s", getEscapeKernelName(), coloring ), 
+                  20, GetScreenHeight() - 80, 20, BLACK );
+    }
+    if ( deepZoom ) {
+        DrawText( TextFormat( "zoom profundo (D): largura %.3g, %d bits, %d iterações (Page Up/Down)", 
+                              2 * radiusX, centerX.limbs * 32, maxIterations ), 
+                  20, GetScreenHeight() - 100, 20, BLACK );
+    } else if ( mandelbrot ) {
+        DrawText( TextFormat( "D: zoom profundo, %d iterações (Page Up/Down)", maxIterations ), 
+                  20, GetScreenHeight() - 100, 20, BLACK );
+    }
+    FractalCounters counters = getFractalCounters( renderer );
+    DrawText( TextFormat( "sem iterar: %d no cardioide/bulbo, %d periódicos", 
+                          counters.interior, counters.periodic ), 
+              20, GetScreenHeight() - 120, 20, BLACK );
+    if ( subdivision && mandelbrot ) {
+        DrawText( TextFormat( "subdivisão (S, B mostra): %d pixels iterados, %d preenchidos", 
+                              counters.iterated, counters.filled ), 
+                  20, GetScreenHeight() - 140, 20, BLACK );
+    } else {
+        DrawText( TextFormat( "S: subdivisão, %d pixels iterados", counters.iterated ), 
+                  20, GetScreenHeight() - 140, 20, BLACK );
+    }
+    if ( antialiasing ) {
+        DrawText( TextFormat( "suavização (A): %d pixels de borda com %d amostras", 
+                              getFractalRefinedPixels( renderer ), 
+                              SUPERSAMPLING_GRID * SUPERSAMPLING_GRID ), 
+                  20, GetScreenHeight() - 160, 20, BLACK );
+    } else {
+        DrawText( "A: suavização das bordas", 20, GetScreenHeight() - 160, 20, BLACK );
+    }
+    double progress = getFractalRenderProgress( renderer );
+    if ( renderer->refining && progress < 1 ) {
+        DrawText( TextFormat( "suavizando as bordas: %d%%", (int) ( progress * 100 ) ), 
+                  120, GetScreenHeight() - 60, 20, BLACK );
+    } else if ( progress < 1 ) {
+        DrawText( TextFormat( "calculando: %d%% (blocos de %d pixels)", 
+                              (int) ( progress * 100 ), getFractalRenderStep( renderer ) ), 
+                  120, GetScreenHeight() - 60, 20, BLACK );
+    }
 
-                if ( colored ) {
+    // with the image complete, nothing changes until there is some input,
+    // so EndDrawing sleeps until then instead of drawing the same frame
+    if ( isFractalRenderFinished( renderer ) ) {
+        EnableEventWaiting();
+    } else {
+        DisableEventWaiting();
+    }
 
-                    if ( gradient ) {
+    EndDrawing();
 
-                        double diff = 0;
-                        if ( iteration < maxIterations ) {
-                            double logZn = log( x0 * x0 + y0 * y0 ) / 2;
-                            double nu = log( logZn / log(2) ) / log(2);
-                            diff = iteration - 1 - nu;
-                        }
+}
 
-                        double vStart = diff;
-                        double vEnd = diff;
+/**
+ * @brief Reads the fractal of the command line arguments of posters and
+ * zoom videos: argv[5] to argv[16] are minX maxX minY maxY maxIterations
+ * mandelbrot cx cy colored gradient hueStart hueEnd.
+ */
+FractalParams readFractalParams( char *argv[] ) {
+    return (FractalParams) {
+        .minX = strtod( argv[5], NULL ),
+        .maxX = strtod( argv[6], NULL ),
+        .minY = strtod( argv[7], NULL ),
+        .maxY = strtod( argv[8], NULL ),
+        .maxIterations = atoi( argv[9] ),
+        .mandelbrot = atoi( argv[10] ) != 0,
+        .cx = strtod( argv[11], NULL ),
+        .cy = strtod( argv[12], NULL ),
+        .colored = atoi( argv[13] ) != 0,
+        .gradient = atoi( argv[14] ) != 0,
+        .hueStart = strtod( argv[15], NULL ),
+        .hueEnd = strtod( argv[16], NULL ),
+        .scapeRadius = 2
+    };
+}
 
-                        Color color1 = ColorFromHSV( 
-                                hueControlStart.value + 
-                                ( hueControlEnd.value - hueControlStart.value ) * 
-                                ( ((int) vStart) / (double) maxIterations ), 
-                                1, 0.7 );
-                        Color color2 = ColorFromHSV( 
-                                hueControlStart.value + 
-                                ( hueControlEnd.value - hueControlStart.value ) * 
-                                ( ((int) (vEnd+1)) / (double) maxIterations ), 
-                                1, 0.7 );
+/**
+ * @brief Renders a poster from the command line arguments:
+ * --poster file width height minX maxX minY maxY maxIterations
+ * mandelbrot cx cy colored gradient hueStart hueEnd
+ */
+int renderPoster( int argc, char *argv[] ) {
+
+    // the sizes must be positive
+    if ( argc != POSTER_ARGUMENTS || atoi( argv[3] ) <= 0 || atoi( argv[4] ) <= 0 ) {
+        printf( "uso: %s --poster arquivo(.png ou .ppm) largura altura minX maxX minY maxY "
+                "iterações mandelbrot(0/1) cx cy colorido(0/1) gradiente(0/1) matizInicial matizFinal\n", 
+                argv[0] );
+        return 1;
+    }
 
-                        diff = diff - ((long)diff);
+    const char *fileName = argv[2];
+    int width = atoi( argv[3] );
+    int height = atoi( argv[4] );
+    FractalParams params = readFractalParams( argv );
 
-                        color = (Color) {
-                            .r = Lerp( color1.r, color2.r, diff ),
-                            .g = Lerp( color1.g, color2.g, diff ),
-                            .b = Lerp( color1.b, color2.b, diff ),
-                            .a = 255
-                        };
+    int threadCount = getProcessorCount();
+    printf( "renderizando %s (%dx%d) com %d threads, kernel %s...\n", 
+            fileName, width, height, threadCount, getEscapeKernelName() );
 
-                    } else {
+    PosterStats stats;
+    if ( !renderFractalPoster( &params, width, height, fileName, threadCount, &stats ) ) {
+        printf( "não foi possível escrever %s\n", fileName );
+        return 1;
+    }
 
-                        color = ColorFromHSV( hueControlStart.value + 
-                            ( hueControlEnd.value - hueControlStart.value ) * 
-                            ( iteration / (double) maxIterations ), 
-                            1, 0.7 );
+    printf( "%.1f megapixels em %.2f s: %.2f megapixels/s\n", 
+            (double) width * height / 1e6, stats.seconds, stats.megapixelsPerSecond );
+    return 0;
 
-                    }
+}
 
-                } else {
+/**
+ * @brief Copies to the clipboard the command that renders a poster of
+ * the current view.
+ */
+void copyPosterCommand( void ) {
 
-                    int c;
-                    
-                    if ( gradient ) {
+    if ( deepZoom ) {
+        TraceLog( LOG_WARNING, "o pôster não suporta o zoom profundo" );
+        return;
+    }
 
-                        double diff = 0;
-                        if ( iteration < maxIterations ) {
-                            double logZn = log( x0 * x0 + y0 * y0 ) / 2;
-                            double nu = log( logZn / log(2) ) / log(2);
-                            diff = iteration - 1 - nu;
-                        }
-                        
-                        double c1 = 255 * (diff) / ( (double) maxIterations );
-                        double c2 = 255 * (diff+1) / ( (double) maxIterations );
-                        diff = diff - ((long)diff);
+    const char *command = TextFormat( "%s --poster poster.png %d %d %.17g %.17g %.17g %.17g %d %d %.17g %.17g %d %d %g %g",
+                                      programName, POSTER_SIZE, POSTER_SIZE, minX, maxX, minY, maxY, 
+                                      maxIterations, mandelbrot, cx, cy, colored, gradient, 
+                                      hueControlStart.value, hueControlEnd.value );
+    SetClipboardText( command );
+    TraceLog( LOG_INFO, "comando do pôster copiado: %s", command );
 
-                        c = Lerp( c1, c2, diff );
+}
 
-                    } else {
-                        c = 255 - 255 * ( iteration / (double) maxIterations );
-                    }
+/**
+ * @brief Renders a zoom video from the command line arguments:
+ * --zoom file width height minX maxX minY maxY maxIterations mandelbrot
+ * cx cy colored gradient hueStart hueEnd targetX targetY zoom frames
+ */
+int renderZoomVideo( int argc, char *argv[] ) {
+
+    // the sizes and the number of frames must be positive
+    if ( argc != ZOOM_VIDEO_ARGUMENTS || atoi( argv[3] ) <= 0 || atoi( argv[4] ) <= 0 || 
+         atoi( argv[20] ) <= 0 ) {
+        printf( "uso: %s --zoom arquivo(.y4m ou padrão como quadro%%05d.png) largura altura "
+                "minX maxX minY maxY iterações mandelbrot(0/1) cx cy colorido(0/1) gradiente(0/1) "
+                "matizInicial matizFinal alvoX alvoY zoom quadros\n", 
+                argv[0] );
+        return 1;
+    }
 
-                    color.r = c;
-                    color.g = c;
-                    color.b = c;
+    const char *fileName = argv[2];
+    int width = atoi( argv[3] );
+    int height = atoi( argv[4] );
+    FractalParams params = readFractalParams( argv );
+    double targetX = strtod( argv[17], NULL );
+    double targetY = strtod( argv[18], NULL );
+    double zoom = strtod( argv[19], NULL );
+    int frames = atoi( argv[20] );
+
+    int threadCount = getProcessorCount();
+    printf( "renderizando %d quadros de %s (%dx%d) com %d threads, kernel %s...\n", 
+            frames, fileName, width, height, threadCount, getEscapeKernelName() );
+
+    ZoomVideoStats stats;
+    if ( !renderFractalZoomVideo( &params, width, height, targetX, targetY, zoom, frames,
+                                  fileName, threadCount, &stats ) ) {
+        printf( "não foi possível escrever %s\n", fileName );
+        return 1;
+    }
 
-                }
+    printf( "%d quadros em %.2f s: %.2f quadros/s, %.1f%% das amostras reaproveitadas\n", 
+            stats.frames, stats.seconds, stats.framesPerSecond, stats.reusedFraction * 100 );
+    return 0;
 
-            }
+}
 
-            DrawPixel( px, py, color );
+/**
+ * @brief Copies to the clipboard the command that renders a video of the
+ * zoom from the whole fractal to the current view, at its center.
+ */
+void copyZoomVideoCommand( void ) {
 
-        }
+    if ( deepZoom ) {
+        TraceLog( LOG_WARNING, "o vídeo não suporta o zoom profundo" );
+        return;
     }
 
-    if ( zooming ) {
-        DrawRectangleLines( 
-            GetMouseX() - ZOOM_SQUARE_SIZE / 2, 
-            GetMouseY() - ZOOM_SQUARE_SIZE / 2, 
-            ZOOM_SQUARE_SIZE, 
-            ZOOM_SQUARE_SIZE, 
-            BLACK );
+    double targetX = ( minX + maxX ) / 2;
+    double targetY = ( minY + maxY ) / 2;
+    double zoom = ( mandelbrot ? MAX_X - MIN_X : 2 * scapeRadius ) / ( maxX - minX );
+    if ( zoom <= 1 ) {
+        TraceLog( LOG_WARNING, "não há zoom para o vídeo" );
+        return;
     }
 
-    if ( colored ) {
-        drawColorBar( &colorBar );
+    // the first frame has the width of the whole fractal
+    double startRadiusX = ( maxX - minX ) / 2 * zoom;
+    double startRadiusY = ( maxY - minY ) / 2 * zoom;
+    int frames = (int) ceil( log2( zoom ) * ZOOM_VIDEO_FRAMES_PER_DOUBLING ) + 1;
+
+    const char *command = TextFormat( "%s --zoom zoom.y4m %d %d %.17g %.17g %.17g %.17g %d %d %.17g %.17g %d %d %g %g %.17g %.17g %.17g %d",
+                                      programName, ZOOM_VIDEO_SIZE, ZOOM_VIDEO_SIZE, 
+                                      targetX - startRadiusX, targetX + startRadiusX, 
+                                      targetY - startRadiusY, targetY + startRadiusY, 
+                                      maxIterations, mandelbrot, cx, cy, colored, gradient, 
+                                      hueControlStart.value, hueControlEnd.value,
+                                      targetX, targetY, zoom, frames );
+    SetClipboardText( command );
+    TraceLog( LOG_INFO, "comando do vídeo copiado: %s", command );
+
+}
+
+/**
+ * @brief Saves the current view in the zoom stack, that grows as needed.
+ */
+void pushZoomLevel( void ) {
+
+    if ( currentZoom == zoomCapacity ) {
+        zoomCapacity = zoomCapacity == 0 ? 16 : zoomCapacity * 2;
+        zoomLevels = (ZoomLevel*) realloc( zoomLevels, sizeof( ZoomLevel ) * zoomCapacity );
     }
 
-    if ( !mandelbrot ) {
-        drawComplexBar( &complexBar );
+    zoomLevels[currentZoom++] = (ZoomLevel) {
+        .minX = minX,
+        .maxX = maxX,
+        .minY = minY,
+        .maxY = maxY,
+        .deepZoom = deepZoom,
+        .centerX = centerX,
+        .centerY = centerY,
+        .radiusX = radiusX,
+        .radiusY = radiusY
+    };
+
+}
+
+/**
+ * @brief Restores the last view saved in the zoom stack.
+ */
+void popZoomLevel( void ) {
+
+    ZoomLevel *level = &zoomLevels[--currentZoom];
+
+    minX = level->minX;
+    maxX = level->maxX;
+    minY = level->minY;
+    maxY = level->maxY;
+    deepZoom = level->deepZoom;
+    centerX = level->centerX;
+    centerY = level->centerY;
+    radiusX = level->radiusX;
+    radiusY = level->radiusY;
+
+}
+
+/**
+ * @brief Zooms the deep zoom view to the rectangle of the screen from
+ * ( xStart, yStart ) to ( xEnd, yEnd ), moving the center with as many
+ * bits as the new pixel size needs.
+ */
+void zoomDeep( double xStart, double xEnd, double yStart, double yEnd ) {
+
+    double width = GetScreenWidth();
+    double height = GetScreenHeight();
+    double offsetX = ( ( xStart + xEnd ) / width - 1 ) * radiusX;
+    double offsetY = ( ( yStart + yEnd ) / height - 1 ) * radiusY;
+
+    radiusX *= ( xEnd - xStart ) / width;
+    radiusY *= ( yEnd - yStart ) / height;
+
+    setBigFloatLimbs( &centerX, getBigFloatLimbsFor( 2 * radiusX / width ) );
+    setBigFloatLimbs( &centerY, getBigFloatLimbsFor( 2 * radiusY / height ) );
+    bigFloatAddDouble( &centerX, offsetX );
+    bigFloatAddDouble( &centerY, offsetY );
+
+}
+
+/**
+ * @brief Enables or disables the deep zoom, converting the current view.
+ */
+void setDeepZoom( bool enabled ) {
+
+    if ( enabled ) {
+        radiusX = ( maxX - minX ) / 2;
+        radiusY = ( maxY - minY ) / 2;
+        if ( !deepZoom ) {
+            centerX = bigFloatFromDouble( minX + radiusX, getBigFloatLimbsFor( 2 * radiusX / GetScreenWidth() ) );
+            centerY = bigFloatFromDouble( minY + radiusY, getBigFloatLimbsFor( 2 * radiusY / GetScreenHeight() ) );
+        } else {
+            centerX = bigFloatFromDouble( minX + radiusX, centerX.limbs );
+            centerY = bigFloatFromDouble( minY + radiusY, centerY.limbs );
+        }
+    } else if ( deepZoom ) {
+        double x = bigFloatToDouble( &centerX );
+        double y = bigFloatToDouble( &centerY );
+        minX = x - radiusX;
+        maxX = x + radiusX;
+        minY = y - radiusY;
+        maxY = y + radiusY;
     }
 
-    DrawFPS( 20, GetScreenHeight() - 60 );
-    EndDrawing();
+    deepZoom = enabled;
 
 }
 